@@ -0,0 +1,213 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../TwiceHashedTest/ControlGroup.h"
+#include "../TwiceHashedTest/HashPolicy.h"
+
+// Блочная (множественно-ассоциативная) кукушка: один массив корзин по
+// Ways слотов, у ключа Hashes независимых корзин-кандидатов. Ключи корзины
+// лежат в одной кэш-линии и сравниваются разом (SSE2/AVX2, если доступны),
+// строки значений — в отдельном массиве и читаются только при совпадении.
+// Таблица держит загрузку kMaxLoad (90–95%) вместо 50% у CuckooHashTable.
+// Policy задаёт число корзин и индекс корзины по хэшу (см. HashPolicy.h).
+template <size_t Ways = 4, size_t Hashes = 2, typename Policy = Pow2MixPolicy>
+class BasicBucketCuckooHashTable {
+    static_assert(Ways == 4 || Ways == 8, "bucket holds 4 or 8 keys");
+    static_assert(Hashes >= 2 && Hashes <= 4, "2 to 4 candidate buckets");
+
+public:
+    static constexpr float kMaxLoad = Ways == 8 || Hashes > 2 ? 0.95f : 0.9f;
+    // Вытеснений на одну вставку, после чего таблица растёт
+    static constexpr int kMaxKicks = 500;
+
+private:
+    static constexpr size_t kBucketAlign = Ways * sizeof(int32_t) + sizeof(uint32_t) <= 32 ? 32 : 64;
+
+    struct alignas(kBucketAlign) Bucket {
+        int32_t keys[Ways];
+        uint32_t used; // бит i — слот i занят
+    };
+
+    std::vector<Bucket> buckets;
+    std::vector<std::string> values; // слот i корзины b — values[b * Ways + i]
+    size_t size;
+    uint32_t rng; // выбор жертвы вытеснения
+
+    // i-я функция семейства: splitmix64 от ключа со своим смещением
+    static size_t keyHash(int key, size_t i) {
+        return static_cast<size_t>(Pow2MixPolicy::mix2(static_cast<uint32_t>(key) + i * 0x9E3779B97F4A7C15ull));
+    }
+    size_t bucketOf(int key, size_t i) const { return Policy::index(keyHash(key, i), buckets.size()); }
+
+    // Слоты корзины с данным ключом (только занятые)
+    static uint32_t match(const Bucket& b, int key) {
+        uint32_t m = 0;
+#if defined(HASHTABLE_GROUP_AVX2)
+        if constexpr (Ways == 8) {
+            __m256i k = _mm256_load_si256(reinterpret_cast<const __m256i*>(b.keys));
+            __m256i eq = _mm256_cmpeq_epi32(k, _mm256_set1_epi32(key));
+            m = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+            return m & b.used;
+        }
+#endif
+#if defined(HASHTABLE_GROUP_SSE2) || defined(HASHTABLE_GROUP_AVX2)
+        __m128i needle = _mm_set1_epi32(key);
+        for (size_t i = 0; i < Ways; i += 4) {
+            __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(b.keys + i));
+            __m128i eq = _mm_cmpeq_epi32(k, needle);
+            m |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(eq))) << i;
+        }
+#else
+        for (size_t i = 0; i < Ways; ++i) {
+            if (b.keys[i] == key) m |= 1u << i;
+        }
+#endif
+        return m & b.used;
+    }
+
+    // Индекс в values или values.size()
+    size_t slotOf(int key) const {
+        size_t pos[Hashes];
+        for (size_t i = 0; i < Hashes; ++i) {
+            pos[i] = bucketOf(key, i);
+            __builtin_prefetch(&buckets[pos[i]]);
+        }
+        for (size_t i = 0; i < Hashes; ++i) {
+            uint32_t m = match(buckets[pos[i]], key);
+            if (m != 0) return pos[i] * Ways + __builtin_ctz(m);
+        }
+        return values.size();
+    }
+
+    uint32_t nextRandom() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    // Кладёт пару, вытесняя соседей. При неудаче key/value — пара,
+    // оставшаяся без места (не обязательно исходная).
+    bool place(int& key, std::string& value) {
+        const uint32_t full = (1u << Ways) - 1;
+        for (int kick = 0; kick <= kMaxKicks; ++kick) {
+            size_t pos[Hashes];
+            for (size_t i = 0; i < Hashes; ++i) {
+                pos[i] = bucketOf(key, i);
+                Bucket& b = buckets[pos[i]];
+                if (b.used != full) {
+                    int slot = __builtin_ctz(~b.used & full);
+                    b.keys[slot] = key;
+                    b.used |= 1u << slot;
+                    values[pos[i] * Ways + slot] = std::move(value);
+                    return true;
+                }
+            }
+            if (kick == kMaxKicks) break;
+
+            uint32_t r = nextRandom();
+            size_t victim = pos[r % Hashes];
+            size_t slot = (r / Hashes) % Ways;
+            std::swap(key, buckets[victim].keys[slot]);
+            std::swap(value, values[victim * Ways + slot]);
+        }
+        return false;
+    }
+
+    // Переносит все пары из таблицы в out
+    void drain(std::vector<std::pair<int, std::string>>& out) {
+        for (size_t b = 0; b < buckets.size(); ++b) {
+            for (size_t i = 0; i < Ways; ++i) {
+                if (buckets[b].used & (1u << i)) out.emplace_back(buckets[b].keys[i], std::move(values[b * Ways + i]));
+            }
+        }
+    }
+
+    // Перестраивает таблицу на bucketCount корзин (или больше, если пары не уложились)
+    void rebuild(size_t bucketCount) {
+        std::vector<std::pair<int, std::string>> entries;
+        entries.reserve(size);
+        drain(entries);
+        for (;;) {
+            buckets.assign(bucketCount, Bucket{{}, 0});
+            values.assign(bucketCount * Ways, std::string());
+
+            size_t i = 0;
+            for (; i < entries.size(); ++i) {
+                if (!place(entries[i].first, entries[i].second)) break;
+            }
+            if (i == entries.size()) return;
+
+            // Бездомная пара осталась в entries[i]; собрать всё заново и расти
+            std::vector<std::pair<int, std::string>> rest;
+            rest.reserve(entries.size());
+            drain(rest);
+            for (; i < entries.size(); ++i) rest.push_back(std::move(entries[i]));
+            entries.swap(rest);
+            bucketCount = Policy::grow(bucketCount);
+        }
+    }
+
+public:
+    BasicBucketCuckooHashTable(size_t initialCapacity = 16)
+        : buckets(Policy::roundCapacity((initialCapacity + Ways - 1) / Ways), Bucket{{}, 0}),
+          values(buckets.size() * Ways), size(0), rng(0x9E3779B9u) {}
+
+    // Дубликат — false, значение не меняется (как CuckooHashTable::insert)
+    bool insert(int key, const std::string& value) {
+        if (slotOf(key) != values.size()) return false;
+        if (size + 1 > getCapacity() * kMaxLoad) rebuild(Policy::grow(buckets.size()));
+
+        int k = key;
+        std::string v = value;
+        while (!place(k, v)) {
+            // Бездомная пара k/v уже не в таблице: перестроить и положить её
+            rebuild(Policy::grow(buckets.size()));
+        }
+        ++size;
+        return true;
+    }
+
+    // Указатель на значение или nullptr; действителен до следующего изменения
+    const std::string* find(int key) const {
+        size_t i = slotOf(key);
+        return i == values.size() ? nullptr : &values[i];
+    }
+
+    std::string search(int key) const {
+        const std::string* value = find(key);
+        return value != nullptr ? *value : "";
+    }
+
+    bool contains(int key) const { return slotOf(key) != values.size(); }
+
+    bool remove(int key) {
+        size_t i = slotOf(key);
+        if (i == values.size()) return false;
+        buckets[i / Ways].used &= ~(1u << (i % Ways));
+        values[i] = std::string();
+        --size;
+        return true;
+    }
+
+    void clear() {
+        for (auto& b : buckets) b.used = 0;
+        for (auto& v : values) v = std::string();
+        size = 0;
+    }
+
+    size_t getSize() const { return size; }
+    bool isEmpty() const { return size == 0; }
+    // Ёмкость в слотах
+    size_t getCapacity() const { return buckets.size() * Ways; }
+    size_t getBucketCount() const { return buckets.size(); }
+    float loadFactor() const { return static_cast<float>(size) / getCapacity(); }
+
+    // Байты корзин и массива значений (без содержимого длинных строк)
+    size_t memoryUsage() const { return buckets.capacity() * sizeof(Bucket) + values.capacity() * sizeof(std::string); }
+};
+
+using BucketCuckooHashTable = BasicBucketCuckooHashTable<>;
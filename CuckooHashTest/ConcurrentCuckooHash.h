@@ -0,0 +1,346 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include "../TwiceHashedTest/EpochReclaim.h"
+#include "../TwiceHashedTest/HashPolicy.h"
+
+// Кукушка для многопоточной работы: у ключа ровно два слота, поэтому
+// читателю хватает двух слотов и двух счётчиков версий.
+//
+// Слоты разбиты на kStripes полос. Счётчик версии полосы — одновременно её
+// блокировка: нечётный, пока полосу держит писатель. Читатель не берёт
+// блокировок: читает версии обеих полос, оба слота и перепроверяет версии
+// (seqlock). Писатель блокирует полосы двух слотов ключа по возрастанию
+// номера. Путь вытеснения ищется без блокировок, затем исполняется с конца:
+// каждый перенос — под блокировкой двух полос с проверкой, что путь не
+// изменился; ключ всё время виден ровно в одном из своих слотов.
+// Рост блокирует все полосы. Значения и старые массивы уходят в EpochDomain.
+template <typename Policy = Pow2MixPolicy>
+class BasicConcurrentCuckooHashTable {
+public:
+    static constexpr size_t kStripes = 1024;
+    static constexpr int kMaxPathDepth = 128;
+
+private:
+    using V = std::string;
+
+    struct Slot {
+        std::atomic<int> key{0};
+        std::atomic<const V*> value{nullptr}; // nullptr — слот пуст
+    };
+
+    struct Array {
+        size_t capacity;
+        uint64_t seed1;
+        uint64_t seed2;
+        Slot* slots; // [0, capacity) — первая таблица, [capacity, 2 * capacity) — вторая
+
+        Array(size_t c, uint64_t s1, uint64_t s2) : capacity(c), seed1(s1), seed2(s2), slots(new Slot[2 * c]) {}
+        ~Array() { delete[] slots; }
+        Array(const Array&) = delete;
+        Array& operator=(const Array&) = delete;
+
+        size_t slot1(int key) const {
+            return Policy::index(static_cast<size_t>(Pow2MixPolicy::mix2(static_cast<uint32_t>(key) ^ seed1)), capacity);
+        }
+        size_t slot2(int key) const {
+            return capacity +
+                   Policy::index(static_cast<size_t>(Pow2MixPolicy::mix2(static_cast<uint32_t>(key) ^ seed2)), capacity);
+        }
+        // Второй слот ключа, лежащего в слоте i
+        size_t alternate(size_t i, int key) const { return i < capacity ? slot2(key) : slot1(key); }
+    };
+
+    struct alignas(64) Stripe {
+        std::atomic<uint32_t> version{0};
+    };
+
+    std::atomic<Array*> current;
+    std::atomic<size_t> size;
+    Stripe stripes[kStripes];
+    std::atomic<uint64_t> seedCounter;
+
+    static size_t stripeOf(size_t slot) { return slot & (kStripes - 1); }
+
+    void lockStripe(size_t s) {
+        std::atomic<uint32_t>& version = stripes[s].version;
+        for (;;) {
+            uint32_t v = version.load(std::memory_order_relaxed);
+            if (!(v & 1) && version.compare_exchange_weak(v, v + 1, std::memory_order_acquire)) break;
+            std::this_thread::yield();
+        }
+        // Записи в слоты не должны стать видны раньше нечётной версии
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void unlockStripe(size_t s) { stripes[s].version.fetch_add(1, std::memory_order_release); }
+
+    // Две полосы по возрастанию номера (порядок общий для всех писателей)
+    void lockPair(size_t a, size_t b) {
+        if (a > b) std::swap(a, b);
+        lockStripe(a);
+        if (b != a) lockStripe(b);
+    }
+    void unlockPair(size_t a, size_t b) {
+        unlockStripe(a);
+        if (b != a) unlockStripe(b);
+    }
+
+    // Значение ключа или nullptr; вызывать внутри EpochGuard
+    const V* lookup(int key) const {
+        for (;;) {
+            const Array* a = current.load(std::memory_order_acquire);
+            size_t i1 = a->slot1(key);
+            size_t i2 = a->slot2(key);
+            const std::atomic<uint32_t>& ver1 = stripes[stripeOf(i1)].version;
+            const std::atomic<uint32_t>& ver2 = stripes[stripeOf(i2)].version;
+            uint32_t v1 = ver1.load(std::memory_order_acquire);
+            uint32_t v2 = ver2.load(std::memory_order_acquire);
+            if ((v1 | v2) & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const V* value1 = a->slots[i1].value.load(std::memory_order_relaxed);
+            int key1 = a->slots[i1].key.load(std::memory_order_relaxed);
+            const V* value2 = a->slots[i2].value.load(std::memory_order_relaxed);
+            int key2 = a->slots[i2].key.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (ver1.load(std::memory_order_relaxed) != v1 || ver2.load(std::memory_order_relaxed) != v2) continue;
+            // Массив заменён ростом: прочитанное могло устареть
+            if (current.load(std::memory_order_acquire) != a) continue;
+
+            if (value1 != nullptr && key1 == key) return value1;
+            if (value2 != nullptr && key2 == key) return value2;
+            return nullptr;
+        }
+    }
+
+    // Путь от слота ключа до свободного, найденный без блокировок: path[0] —
+    // один из слотов ключа, path[n - 1] — свободный. Ноль — пути нет.
+    int findPath(const Array* a, int key, size_t* path) const {
+        struct Step {
+            size_t slot;
+            int parent;
+        };
+        Step steps[2 * kMaxPathDepth + 2];
+        int count = 0;
+        steps[count++] = {a->slot1(key), -1};
+        steps[count++] = {a->slot2(key), -1};
+
+        for (int head = 0; head < count; ++head) {
+            const Slot& s = a->slots[steps[head].slot];
+            if (s.value.load(std::memory_order_relaxed) == nullptr) {
+                int n = 0;
+                for (int j = head; j != -1; j = steps[j].parent) ++n;
+                int k = n;
+                for (int j = head; j != -1; j = steps[j].parent) path[--k] = steps[j].slot;
+                return n;
+            }
+            if (count == static_cast<int>(sizeof(steps) / sizeof(steps[0]))) continue;
+            size_t next = a->alternate(steps[head].slot, s.key.load(std::memory_order_relaxed));
+            bool seen = false;
+            for (int j = 0; j < count && !seen; ++j) seen = steps[j].slot == next;
+            if (!seen) steps[count++] = {next, head};
+        }
+        return 0;
+    }
+
+    // Переносит ключ из from в пустой to. false — путь успел измениться.
+    bool moveSlot(Array* a, size_t from, size_t to) {
+        size_t sf = stripeOf(from);
+        size_t st = stripeOf(to);
+        lockPair(sf, st);
+        bool ok = current.load(std::memory_order_relaxed) == a;
+        Slot& src = a->slots[from];
+        Slot& dst = a->slots[to];
+        const V* value = src.value.load(std::memory_order_relaxed);
+        int key = src.key.load(std::memory_order_relaxed);
+        ok = ok && value != nullptr && dst.value.load(std::memory_order_relaxed) == nullptr &&
+             a->alternate(from, key) == to;
+        if (ok) {
+            dst.key.store(key, std::memory_order_relaxed);
+            dst.value.store(value, std::memory_order_relaxed);
+            src.value.store(nullptr, std::memory_order_relaxed);
+        }
+        unlockPair(sf, st);
+        return ok;
+    }
+
+    // Однопоточное размещение при росте (все полосы заблокированы).
+    // При неудаче новый массив выбрасывается, значения остаются в старом.
+    static bool placeLocked(Array* a, int key, const V* value) {
+        size_t i = a->slot1(key);
+        for (int step = 0; step < 4 * kMaxPathDepth; ++step) {
+            Slot& s = a->slots[i];
+            const V* displaced = s.value.load(std::memory_order_relaxed);
+            int displacedKey = s.key.load(std::memory_order_relaxed);
+            s.key.store(key, std::memory_order_relaxed);
+            s.value.store(value, std::memory_order_relaxed);
+            if (displaced == nullptr) return true;
+            key = displacedKey;
+            value = displaced;
+            i = a->alternate(i, key);
+        }
+        return false;
+    }
+
+    Array* newArray(size_t capacity) {
+        uint64_t n = seedCounter.fetch_add(2, std::memory_order_relaxed);
+        return new Array(capacity, Pow2MixPolicy::mix(n + 1), Pow2MixPolicy::mix(n + 2));
+    }
+
+    // Рост (или перестройка с новыми зёрнами при той же ёмкости) массива a
+    void grow(Array* a, bool sameCapacity) {
+        for (size_t s = 0; s < kStripes; ++s) lockStripe(s);
+        if (current.load(std::memory_order_relaxed) == a) {
+            size_t capacity = sameCapacity ? a->capacity : Policy::grow(a->capacity);
+            for (;;) {
+                Array* next = newArray(capacity);
+                bool placed = true;
+                for (size_t i = 0; i < 2 * a->capacity && placed; ++i) {
+                    const V* value = a->slots[i].value.load(std::memory_order_relaxed);
+                    if (value != nullptr) placed = placeLocked(next, a->slots[i].key.load(std::memory_order_relaxed), value);
+                }
+                if (placed) {
+                    current.store(next, std::memory_order_release);
+                    break;
+                }
+                // Значения принадлежат старому массиву; новый удаляется без них
+                delete next;
+                capacity = Policy::grow(capacity);
+            }
+            EpochDomain::instance().retire(a);
+        }
+        for (size_t s = 0; s < kStripes; ++s) unlockStripe(s);
+    }
+
+public:
+    BasicConcurrentCuckooHashTable(size_t initialCapacity = 11) : size(0), seedCounter(0) {
+        current.store(newArray(Policy::roundCapacity(initialCapacity)), std::memory_order_relaxed);
+    }
+
+    // Разрушение — только когда таблицей уже никто не пользуется
+    ~BasicConcurrentCuckooHashTable() {
+        Array* a = current.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < 2 * a->capacity; ++i) delete a->slots[i].value.load(std::memory_order_relaxed);
+        delete a;
+    }
+
+    BasicConcurrentCuckooHashTable(const BasicConcurrentCuckooHashTable&) = delete;
+    BasicConcurrentCuckooHashTable& operator=(const BasicConcurrentCuckooHashTable&) = delete;
+
+    // Дубликат — false, значение не меняется (как CuckooHashTable::insert)
+    bool insert(int key, const std::string& value) {
+        const V* fresh = new V(value);
+        size_t path[2 * kMaxPathDepth + 2];
+        EpochGuard epoch;
+        for (;;) {
+            Array* a = current.load(std::memory_order_acquire);
+            if (static_cast<float>(size.load(std::memory_order_relaxed) + 1) / (a->capacity * 2) >= 0.5f) {
+                grow(a, false);
+                continue;
+            }
+
+            size_t i1 = a->slot1(key);
+            size_t i2 = a->slot2(key);
+            size_t s1 = stripeOf(i1);
+            size_t s2 = stripeOf(i2);
+            lockPair(s1, s2);
+            if (current.load(std::memory_order_relaxed) != a) {
+                unlockPair(s1, s2);
+                continue;
+            }
+            Slot& slot1 = a->slots[i1];
+            Slot& slot2 = a->slots[i2];
+            const V* value1 = slot1.value.load(std::memory_order_relaxed);
+            const V* value2 = slot2.value.load(std::memory_order_relaxed);
+            if ((value1 != nullptr && slot1.key.load(std::memory_order_relaxed) == key) ||
+                (value2 != nullptr && slot2.key.load(std::memory_order_relaxed) == key)) {
+                unlockPair(s1, s2);
+                delete fresh;
+                return false;
+            }
+            Slot* target = value1 == nullptr ? &slot1 : value2 == nullptr ? &slot2 : nullptr;
+            if (target != nullptr) {
+                target->key.store(key, std::memory_order_relaxed);
+                target->value.store(fresh, std::memory_order_relaxed);
+                size.fetch_add(1, std::memory_order_relaxed);
+                unlockPair(s1, s2);
+                return true;
+            }
+            unlockPair(s1, s2);
+
+            // Оба слота заняты: найти путь и освободить его начало
+            int n = findPath(a, key, path);
+            if (n == 0) {
+                grow(a, true);
+                continue;
+            }
+            for (int j = n - 1; j > 0; --j) {
+                if (!moveSlot(a, path[j - 1], path[j])) break;
+            }
+            // Успех или нет — повтор с начала: слот ключа теперь, скорее всего, свободен
+        }
+    }
+
+    bool remove(int key) {
+        EpochGuard epoch;
+        for (;;) {
+            Array* a = current.load(std::memory_order_acquire);
+            size_t i1 = a->slot1(key);
+            size_t i2 = a->slot2(key);
+            size_t s1 = stripeOf(i1);
+            size_t s2 = stripeOf(i2);
+            lockPair(s1, s2);
+            if (current.load(std::memory_order_relaxed) != a) {
+                unlockPair(s1, s2);
+                continue;
+            }
+            const V* removed = nullptr;
+            for (size_t i : {i1, i2}) {
+                Slot& s = a->slots[i];
+                const V* value = s.value.load(std::memory_order_relaxed);
+                if (removed == nullptr && value != nullptr && s.key.load(std::memory_order_relaxed) == key) {
+                    s.value.store(nullptr, std::memory_order_relaxed);
+                    removed = value;
+                }
+            }
+            if (removed != nullptr) size.fetch_sub(1, std::memory_order_relaxed);
+            unlockPair(s1, s2);
+            EpochDomain::instance().retire(const_cast<V*>(removed));
+            return removed != nullptr;
+        }
+    }
+
+    // Поиск без блокировок. Копия значения; для отсутствующего ключа — ""
+    std::string search(int key) const {
+        EpochGuard epoch;
+        const V* value = lookup(key);
+        return value != nullptr ? *value : "";
+    }
+
+    bool tryGet(int key, std::string& out) const {
+        EpochGuard epoch;
+        const V* value = lookup(key);
+        if (value == nullptr) return false;
+        out = *value;
+        return true;
+    }
+
+    bool contains(int key) const {
+        EpochGuard epoch;
+        return lookup(key) != nullptr;
+    }
+
+    size_t getSize() const { return size.load(std::memory_order_relaxed); }
+    bool isEmpty() const { return getSize() == 0; }
+    // Размер одной из двух таблиц, как у CuckooHashTable
+    size_t getCapacity() const { return current.load(std::memory_order_acquire)->capacity; }
+};
+
+using ConcurrentCuckooHashTable = BasicConcurrentCuckooHashTable<>;
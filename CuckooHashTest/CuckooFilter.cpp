@@ -0,0 +1,242 @@
+#include "CuckooFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+// Заголовок файла фильтра; за ним — bucketCount * kSlots отпечатков
+struct FilterHeader {
+    char magic[8];
+    uint32_t fingerprintSize;
+    uint32_t fingerprintBits;
+    uint64_t bucketCount;
+    uint64_t size;
+    uint64_t victimBucket;
+    uint32_t hasVictim;
+    uint32_t victim;
+    uint64_t checksum; // заголовка (с нулём в этом поле) и отпечатков
+};
+constexpr char kFilterMagic[8] = {'C', 'K', 'F', 'I', 'L', 'T', '0', '2'};
+// Предел числа корзин в файле: размер слотов не переполняет uint64_t
+constexpr uint64_t kMaxFileBuckets = uint64_t(1) << 40;
+
+// FNV-1a по 8-байтным словам, как у снимка CuckooHashTable
+uint64_t checksum(uint64_t h, const void* data, size_t n) {
+    const uint64_t prime = 0x100000001B3ull;
+    const char* p = static_cast<const char*>(data);
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ word) * prime;
+    }
+    for (; n > 0; --n, ++p) h = (h ^ static_cast<unsigned char>(*p)) * prime;
+    return h;
+}
+
+uint64_t fileChecksum(FilterHeader header, const void* slots, size_t bytes) {
+    header.checksum = 0;
+    uint64_t h = checksum(0xCBF29CE484222325ull, &header, sizeof(header));
+    return checksum(h, slots, bytes);
+}
+} // namespace
+
+// Бит отпечатка на заданную вероятность ошибки: fpr ~ 2 * kSlots / 2^bits
+template <typename Fingerprint>
+BasicCuckooFilter<Fingerprint>::BasicCuckooFilter(size_t expectedKeys, double falsePositiveRate)
+    : size(0), hasVictim(false), victimBucket(0), victim(0), rng(0x9E3779B9u) {
+    const unsigned maxBits = 8 * sizeof(Fingerprint);
+    double bits = std::ceil(std::log2(2.0 * kSlots / falsePositiveRate));
+    fingerprintBits = bits < kMinFingerprintBits ? kMinFingerprintBits : bits > maxBits ? maxBits : static_cast<unsigned>(bits);
+
+    size_t buckets = static_cast<size_t>(std::ceil(expectedKeys / (kSlots * kMaxLoad)));
+    bucketCount = Pow2MixPolicy::roundCapacity(buckets);
+    slots.assign(bucketCount * kSlots, 0);
+}
+
+// Ноль — пустой слот, поэтому отпечатки берутся из [1, 2^bits)
+template <typename Fingerprint>
+Fingerprint BasicCuckooFilter<Fingerprint>::fingerprintOf(uint64_t h) const {
+    uint64_t fp = (h >> 32) & ((uint64_t(1) << fingerprintBits) - 1);
+    return static_cast<Fingerprint>(fp == 0 ? 1 : fp);
+}
+
+// Инволюция: altBucket(altBucket(b, fp), fp) == b
+template <typename Fingerprint>
+size_t BasicCuckooFilter<Fingerprint>::altBucket(size_t bucket, Fingerprint fp) const {
+    return (bucket ^ static_cast<size_t>(Pow2MixPolicy::mix(fp))) & (bucketCount - 1);
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::bucketHas(size_t bucket, Fingerprint fp) const {
+    const Fingerprint* b = &slots[bucket * kSlots];
+    for (size_t i = 0; i < kSlots; ++i) {
+        if (b[i] == fp) return true;
+    }
+    return false;
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::addToBucket(size_t bucket, Fingerprint fp) {
+    Fingerprint* b = &slots[bucket * kSlots];
+    for (size_t i = 0; i < kSlots; ++i) {
+        if (b[i] == 0) {
+            b[i] = fp;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::removeFromBucket(size_t bucket, Fingerprint fp) {
+    Fingerprint* b = &slots[bucket * kSlots];
+    for (size_t i = 0; i < kSlots; ++i) {
+        if (b[i] == fp) {
+            b[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Вытеснение как в CuckooHashTable, но переносится только отпечаток.
+// При неудаче без места остаётся какой-то отпечаток — он ждёт в victim.
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::relocate(size_t bucket, Fingerprint fp) {
+    for (int kick = 0; kick < kMaxKicks; ++kick) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        std::swap(fp, slots[bucket * kSlots + rng % kSlots]);
+        bucket = altBucket(bucket, fp);
+        if (addToBucket(bucket, fp)) {
+            hasVictim = false;
+            return true;
+        }
+    }
+    hasVictim = true;
+    victimBucket = bucket;
+    victim = fp;
+    return false;
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::insert(int key) {
+    // Сначала пристроить ожидающий отпечаток; не вышло — фильтр полон
+    if (hasVictim && !relocate(victimBucket, victim)) return false;
+
+    uint64_t h = keyHash(key);
+    Fingerprint fp = fingerprintOf(h);
+    size_t i1 = static_cast<size_t>(h) & (bucketCount - 1);
+    size_t i2 = altBucket(i1, fp);
+    if (!addToBucket(i1, fp) && !addToBucket(i2, fp)) {
+        // Ключ учитывается и при неудаче: его отпечаток в таблице или в victim
+        relocate((rng & 1) ? i1 : i2, fp);
+    }
+    ++size;
+    return true;
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::contains(int key) const {
+    uint64_t h = keyHash(key);
+    Fingerprint fp = fingerprintOf(h);
+    size_t i1 = static_cast<size_t>(h) & (bucketCount - 1);
+    size_t i2 = altBucket(i1, fp);
+    if (bucketHas(i1, fp) || bucketHas(i2, fp)) return true;
+    return hasVictim && victim == fp && (victimBucket == i1 || victimBucket == i2);
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::remove(int key) {
+    uint64_t h = keyHash(key);
+    Fingerprint fp = fingerprintOf(h);
+    size_t i1 = static_cast<size_t>(h) & (bucketCount - 1);
+    size_t i2 = altBucket(i1, fp);
+
+    if (hasVictim && victim == fp && (victimBucket == i1 || victimBucket == i2)) {
+        hasVictim = false;
+        --size;
+        return true;
+    }
+    if (!removeFromBucket(i1, fp) && !removeFromBucket(i2, fp)) return false;
+    --size;
+
+    // Освободилось место — вернуть ожидающий отпечаток
+    if (hasVictim) relocate(victimBucket, victim);
+    return true;
+}
+
+template <typename Fingerprint>
+void BasicCuckooFilter<Fingerprint>::clear() {
+    std::fill(slots.begin(), slots.end(), 0);
+    size = 0;
+    hasVictim = false;
+}
+
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::serializeToBinary(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    FilterHeader header{};
+    std::memcpy(header.magic, kFilterMagic, sizeof(header.magic));
+    header.fingerprintSize = sizeof(Fingerprint);
+    header.fingerprintBits = fingerprintBits;
+    header.bucketCount = bucketCount;
+    header.size = size;
+    header.victimBucket = victimBucket;
+    header.hasVictim = hasVictim;
+    header.victim = victim;
+    header.checksum = fileChecksum(header, slots.data(), slots.size() * sizeof(Fingerprint));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(Fingerprint));
+
+    out.close();
+    return static_cast<bool>(out);
+}
+
+// false — файла нет, он повреждён, обрезан или записан фильтром с другим
+// Fingerprint; тогда фильтр не меняется
+template <typename Fingerprint>
+bool BasicCuckooFilter<Fingerprint>::deserializeFromBinary(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    FilterHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    const unsigned maxBits = 8 * sizeof(Fingerprint);
+    // Отпечаток жертвы — той же ширины, что и остальные, иначе contains() его не найдёт
+    bool valid = std::memcmp(header.magic, kFilterMagic, sizeof(header.magic)) == 0 &&
+                 header.fingerprintSize == sizeof(Fingerprint) && header.fingerprintBits >= kMinFingerprintBits &&
+                 header.fingerprintBits <= maxBits && header.bucketCount > 0 &&
+                 header.bucketCount <= kMaxFileBuckets && (header.bucketCount & (header.bucketCount - 1)) == 0 &&
+                 header.victimBucket < header.bucketCount && header.hasVictim <= 1 &&
+                 header.size <= header.bucketCount * kSlots + header.hasVictim &&
+                 (header.hasVictim == 0 || (header.victim != 0 && header.victim < (uint64_t(1) << header.fingerprintBits)));
+    if (!valid) return false;
+
+    // Длина файла сверяется до выделения памяти под отпечатки
+    const uint64_t slotBytes = header.bucketCount * kSlots * sizeof(Fingerprint);
+    in.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(in.tellg()) != sizeof(header) + slotBytes) return false;
+    in.seekg(sizeof(header));
+
+    std::vector<Fingerprint> loaded(header.bucketCount * kSlots);
+    if (!in.read(reinterpret_cast<char*>(loaded.data()), slotBytes)) return false;
+    if (fileChecksum(header, loaded.data(), slotBytes) != header.checksum) return false;
+
+    slots.swap(loaded);
+    bucketCount = header.bucketCount;
+    size = header.size;
+    fingerprintBits = header.fingerprintBits;
+    hasVictim = header.hasVictim != 0;
+    victimBucket = header.victimBucket;
+    victim = static_cast<Fingerprint>(header.victim);
+    return true;
+}
+
+template class BasicCuckooFilter<uint8_t>;
+template class BasicCuckooFilter<uint16_t>;
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../TwiceHashedTest/HashPolicy.h"
+
+// Фильтр кукушки: приближённая проверка принадлежности. Вместо ключа
+// и значения хранится только отпечаток ключа (fingerprintBits бит) в
+// корзинах по kSlots слотов. Вторая корзина вычисляется из первой и
+// отпечатка (i2 = i1 ^ hash(fp)), поэтому вытеснять можно без ключа.
+//
+// contains() не ошибается для вставленных ключей; для остальных ложное
+// «да» бывает с вероятностью ~falsePositiveRate. Ширина отпечатка
+// ограничена типом Fingerprint: если для заданной вероятности бит не
+// хватает (CuckooFilter8 при 0.01 нужно 10), берётся наибольшая ширина,
+// а фактическую оценку возвращает achievedFpr(). Повторная вставка ключа
+// добавляет ещё одну копию отпечатка, remove() убирает одну копию;
+// удалять можно только то, что было вставлено.
+//
+// Fingerprint — uint8_t или uint16_t (1 или 2 байта на слот).
+// Реализация и инстанциации — в CuckooFilter.cpp.
+template <typename Fingerprint = uint16_t>
+class BasicCuckooFilter {
+public:
+    static constexpr size_t kSlots = 4;
+    static constexpr float kMaxLoad = 0.95f;
+    // Вытеснений на одну вставку, после чего фильтр считается полным
+    static constexpr int kMaxKicks = 500;
+    // Наименьшая ширина отпечатка, которую выбирает конструктор
+    static constexpr unsigned kMinFingerprintBits = 4;
+
+private:
+    std::vector<Fingerprint> slots; // корзина b — slots[b * kSlots .. b * kSlots + kSlots)
+    size_t bucketCount;             // степень двойки
+    size_t size;
+    unsigned fingerprintBits;
+    // Отпечаток, не нашедший места при последней неудачной вставке
+    // (как тайник у CuckooHashTable); вставка отклоняется, если и ему
+    // не нашлось места
+    bool hasVictim;
+    size_t victimBucket;
+    Fingerprint victim;
+    uint32_t rng;
+
+    static uint64_t keyHash(int key) { return Pow2MixPolicy::mix2(static_cast<uint32_t>(key)); }
+    Fingerprint fingerprintOf(uint64_t h) const;
+    size_t altBucket(size_t bucket, Fingerprint fp) const;
+    bool bucketHas(size_t bucket, Fingerprint fp) const;
+    bool addToBucket(size_t bucket, Fingerprint fp);
+    bool removeFromBucket(size_t bucket, Fingerprint fp);
+    // Кладёт fp, вытесняя соседей; false — бездомный отпечаток в victim
+    bool relocate(size_t bucket, Fingerprint fp);
+
+public:
+    // expectedKeys — сколько ключей должно поместиться при загрузке kMaxLoad
+    explicit BasicCuckooFilter(size_t expectedKeys = 1024, double falsePositiveRate = 0.01);
+
+    // false — фильтр полон, ключ не добавлен
+    bool insert(int key);
+    bool contains(int key) const;
+    bool remove(int key);
+
+    size_t getSize() const { return size; }
+    bool isEmpty() const { return size == 0; }
+    size_t getCapacity() const { return bucketCount * kSlots; }
+    size_t getBucketCount() const { return bucketCount; }
+    unsigned getFingerprintBits() const { return fingerprintBits; }
+    // Оценка вероятности ложного «да» при полных корзинах для выбранной
+    // ширины отпечатка: 2 * kSlots / (2^bits - 1)
+    double achievedFpr() const { return 2.0 * kSlots / ((uint64_t(1) << fingerprintBits) - 1); }
+    float loadFactor() const { return static_cast<float>(size) / getCapacity(); }
+    size_t memoryUsage() const { return slots.capacity() * sizeof(Fingerprint); }
+
+    void clear();
+
+    bool serializeToBinary(const std::string& filename) const;
+    bool deserializeFromBinary(const std::string& filename);
+};
+
+using CuckooFilter = BasicCuckooFilter<uint16_t>;
+using CuckooFilter8 = BasicCuckooFilter<uint8_t>;
@@ -1,182 +1,380 @@
 #include "CuckooHash.h"
 #include <iostream>
 #include <fstream>
-
-static int hash1(int key, int capacity) {
-    return key % capacity;
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<CuckooNode>, "snapshot copies slots byte by byte");
+
+// Снимок таблицы с сохранением раскладки:
+//   Header | table1[capacity] | table2[capacity] | stash[stashCount] |
+//   offsets[size + 1] | байты значений
+// Слоты записаны как в памяти; значение с дескриптором h занимает
+// bytes[offsets[h], offsets[h + 1]). Зёрна сохраняются, поэтому каждый
+// ключ остаётся на своём месте и поиск после загрузки не меняется.
+namespace cuckoo_snapshot {
+
+constexpr char kMagic[8] = {'C', 'K', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr uint64_t kChecksumSeed = 0xCBF29CE484222325ull;
+
+struct Header {
+    char magic[8];
+    uint32_t policyId;
+    uint32_t capacity;
+    uint32_t size;
+    uint32_t stashCount;
+    uint64_t seed1;
+    uint64_t seed2;
+    uint64_t seedCounter;
+    uint64_t bytes; // длина секции значений
+    uint64_t checksum; // всего, что после заголовка
+};
+
+// FNV-1a по 8-байтным словам, хвост — побайтно
+inline uint64_t checksum(uint64_t h, const void* data, size_t n) {
+    const uint64_t prime = 0x100000001B3ull;
+    const char* p = static_cast<const char*>(data);
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ word) * prime;
+    }
+    for (; n > 0; --n, ++p) h = (h ^ static_cast<unsigned char>(*p)) * prime;
+    return h;
 }
 
-static int hash2(int key, int capacity) {
-    return (key / capacity) % capacity;
-}
+} // namespace cuckoo_snapshot
 
-// CuckooNode methods (без изменений)
-CuckooNode::CuckooNode() : key(0), value(""), occupied(false) {}
+// CuckooNode methods
+CuckooNode::CuckooNode() : key(0), handle(kNoValue) {}
 
 int CuckooNode::getKey() const { return key; }
 
-const std::string& CuckooNode::getValue() const { return value; }
-
-bool CuckooNode::isOccupied() const { return occupied; }
+uint32_t CuckooNode::getHandle() const { return handle; }
 
-void CuckooNode::setKey(int k) { key = k; }
+bool CuckooNode::isOccupied() const { return handle != kNoValue; }
 
-void CuckooNode::setValue(const std::string& v) { value = v; }
-
-void CuckooNode::markOccupied() { occupied = true; }
+void CuckooNode::set(int k, uint32_t h) {
+    key = k;
+    handle = h;
+}
 
-void CuckooNode::markEmpty() { occupied = false; }
+void CuckooNode::markEmpty() { handle = kNoValue; }
 
 // CuckooHashTable methods
-CuckooHashTable::CuckooHashTable(int initialCapacity) {
-    capacity = initialCapacity;
-    size = 0;
-    table1 = new CuckooNode[capacity];
-    table2 = new CuckooNode[capacity];
+template <typename Policy>
+BasicCuckooHashTable<Policy>::BasicCuckooHashTable(int initialCapacity)
+    : table1(nullptr), table2(nullptr), size(0), capacity(0), stashCount(0), seedCounter(0),
+      insertMode(CuckooInsertMode::RandomWalk) {
+    reseed();
+    allocate(static_cast<int>(Policy::roundCapacity(initialCapacity)));
 }
 
-CuckooHashTable::~CuckooHashTable() {
+template <typename Policy>
+BasicCuckooHashTable<Policy>::~BasicCuckooHashTable() {
     delete[] table1;
     delete[] table2;
 }
 
-void CuckooHashTable::rehash() {
-    int oldCapacity = capacity;
-    CuckooNode* oldTable1 = table1;
-    CuckooNode* oldTable2 = table2;
+template <typename Policy>
+uint32_t BasicCuckooHashTable<Policy>::storeValue(std::string&& value) {
+    if (!freeHandles.empty()) {
+        uint32_t handle = freeHandles.back();
+        freeHandles.pop_back();
+        values[handle] = std::move(value);
+        return handle;
+    }
+    values.push_back(std::move(value));
+    return static_cast<uint32_t>(values.size() - 1);
+}
+
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::releaseValue(uint32_t handle) {
+    values[handle] = std::string();
+    freeHandles.push_back(handle);
+}
+
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::reseed() {
+    seed1 = Pow2MixPolicy::mix(++seedCounter);
+    seed2 = Pow2MixPolicy::mix(++seedCounter);
+}
 
-    capacity = capacity * 2 + 1;
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::allocate(int newCapacity) {
+    delete[] table1;
+    delete[] table2;
+    capacity = newCapacity;
     table1 = new CuckooNode[capacity];
     table2 = new CuckooNode[capacity];
     size = 0;
+    for (int i = 0; i < stashCount; ++i) stash[i].markEmpty();
+    stashCount = 0;
+}
 
-    for (int i = 0; i < oldCapacity; ++i) {
-        if (oldTable1[i].isOccupied()) {
-            insert(oldTable1[i].getKey(), oldTable1[i].getValue());
-        }
-        if (oldTable2[i].isOccupied()) {
-            insert(oldTable2[i].getKey(), oldTable2[i].getValue());
+// Успешная вставка почти всегда укладывается в O(log n) шагов
+template <typename Policy>
+int BasicCuckooHashTable<Policy>::maxLoop() const {
+    int bits = 0;
+    for (int c = capacity; c > 0; c >>= 1) ++bits;
+    return 16 + 6 * bits;
+}
+
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::place(CuckooNode& node) {
+    if (insertMode == CuckooInsertMode::Bfs) return placeBfs(node);
+
+    const int startKey = node.getKey();
+    int startSeen = 0;
+    int currentTable = 1; // 1 = table1, 2 = table2
+
+    for (int step = 0, limit = maxLoop(); step < limit; ++step) {
+        int pos = (currentTable == 1) ? hash1(node.getKey()) : hash2(node.getKey());
+        CuckooNode* slot = (currentTable == 1) ? &table1[pos] : &table2[pos];
+
+        if (!slot->isOccupied()) {
+            *slot = node;
+            return true;
         }
-    }
 
-    delete[] oldTable1;
-    delete[] oldTable2;
-}
+        // Вытеснение: обмен 8-байтными слотами, строки остаются на месте
+        std::swap(*slot, node);
+        currentTable = (currentTable == 1) ? 2 : 1;
 
+        // Исходный ключ вытеснен в третий раз: путь замкнулся в двух циклах,
+        // свободного слота на нём нет
+        if (node.getKey() == startKey && ++startSeen == 3) break;
+    }
+    return false;
+}
 
+// У слота ровно одна альтернатива (слот его ключа в другой таблице), поэтому
+// дерево поиска — две цепочки от кандидатов ключа; обход в ширину идёт по
+// ним поочерёдно и находит более короткую.
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::placeBfs(const CuckooNode& node) {
+    struct Step {
+        int table;
+        int pos;
+        int parent; // индекс в path, -1 у кандидатов самого ключа
+    };
+    Step path[2 * kMaxBfsDepth + 2];
+    int count = 0;
+    path[count++] = {1, hash1(node.getKey()), -1};
+    path[count++] = {2, hash2(node.getKey()), -1};
+
+    for (int head = 0; head < count; ++head) {
+        const Step step = path[head];
+        const CuckooNode& occupant = nodeAt(step.table, step.pos);
+
+        if (!occupant.isOccupied()) {
+            // Сдвиг с конца пути: каждый ключ переходит в свой второй слот
+            int j = head;
+            while (path[j].parent != -1) {
+                int parent = path[j].parent;
+                nodeAt(path[j].table, path[j].pos) = nodeAt(path[parent].table, path[parent].pos);
+                j = parent;
+            }
+            nodeAt(path[j].table, path[j].pos) = node;
+            return true;
+        }
 
-bool CuckooHashTable::insert(int key, const std::string& value) {
-    if (search(key) != "") {
-        return false;
+        if (count == static_cast<int>(sizeof(path) / sizeof(path[0]))) continue;
+        int table = step.table == 1 ? 2 : 1;
+        int pos = table == 1 ? hash1(occupant.getKey()) : hash2(occupant.getKey());
+        bool seen = false;
+        for (int j = 0; j < count && !seen; ++j) seen = path[j].table == table && path[j].pos == pos;
+        if (!seen) path[count++] = {table, pos, head};
     }
+    return false;
+}
 
-    if (static_cast<float>(size + 1) / (capacity * 2) >= 0.5f) {
-        rehash();
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::drain(Entries& out) const {
+    for (int i = 0; i < capacity; ++i) {
+        if (table1[i].isOccupied()) out.push_back(table1[i]);
+        if (table2[i].isOccupied()) out.push_back(table2[i]);
     }
+    for (int i = 0; i < stashCount; ++i) out.push_back(stash[i]);
+}
 
-    int currentKey = key;
-    std::string currentValue = value;
-    int currentTable = 1; // 1 = table1, 2 = table2
+template <typename Policy>
+const CuckooNode* BasicCuckooHashTable<Policy>::findNode(int key) const {
+    const CuckooNode& n1 = table1[hash1(key)];
+    if (n1.isOccupied() && n1.getKey() == key) return &n1;
+    const CuckooNode& n2 = table2[hash2(key)];
+    if (n2.isOccupied() && n2.getKey() == key) return &n2;
+    if (stashCount > 0) {
+        int i = findInStash(key);
+        if (i >= 0) return &stash[i];
+    }
+    return nullptr;
+}
 
-    const int MAX_ATTEMPTS = capacity * 100; // очень большой запас — вставка почти всегда удаётся
+template <typename Policy>
+int BasicCuckooHashTable<Policy>::findInStash(int key) const {
+    for (int i = 0; i < stashCount; ++i) {
+        if (stash[i].getKey() == key) return i;
+    }
+    return -1;
+}
 
-    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-        int pos = (currentTable == 1) ? hash1(currentKey, capacity) : hash2(currentKey, capacity);
-        CuckooNode* slot = (currentTable == 1) ? &table1[pos] : &table2[pos];
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::pushStash(const CuckooNode& node) {
+    if (stashCount == kStashSize) return false;
+    stash[stashCount++] = node;
+    return true;
+}
 
-        if (!slot->isOccupied()) {
-            slot->setKey(currentKey);
-            slot->setValue(currentValue);
-            slot->markOccupied();
-            ++size;
-            return true;
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::rebuild(int newCapacity, Entries& entries) {
+    for (int attempt = 1;; ++attempt) {
+        if (attempt % kMaxReseeds == 0) newCapacity = static_cast<int>(Policy::grow(newCapacity));
+        reseed();
+        allocate(newCapacity);
+
+        size_t i = 0;
+        while (i < entries.size() && (place(entries[i]) || pushStash(entries[i]))) ++i;
+        if (i == entries.size()) {
+            size = static_cast<int>(entries.size());
+            return;
         }
 
-        // Вытеснение
-        int displacedKey = slot->getKey();
-        std::string displacedValue = slot->getValue();
-        slot->setKey(currentKey);
-        slot->setValue(currentValue);
-
-        currentKey = displacedKey;
-        currentValue = displacedValue;
-        currentTable = (currentTable == 1) ? 2 : 1;
+        // Бездомная пара — в entries[i]; собрать всё заново
+        Entries rest;
+        rest.reserve(entries.size());
+        drain(rest);
+        rest.insert(rest.end(), entries.begin() + i, entries.end());
+        entries.swap(rest);
     }
-
-    // Если не удалось — рехэш и повтор
-    // rehash();
-    //
-    // currentKey = key;
-    // currentValue = value;
-    // currentTable = 1;
-    //
-    // for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-    //     int pos = (currentTable == 1) ? hash1(currentKey, capacity) : hash2(currentKey, capacity);
-    //     CuckooNode* slot = (currentTable == 1) ? &table1[pos] : &table2[pos];
-    //
-    //     if (!slot->isOccupied()) {
-    //         slot->setKey(currentKey);
-    //         slot->setValue(currentValue);
-    //         slot->markOccupied();
-    //         ++size;
-    //         return true;
-    //     }
-    //
-    //     int displacedKey = slot->getKey();
-    //     std::string displacedValue = slot->getValue();
-    //     slot->setKey(currentKey);
-    //     slot->setValue(currentValue);
-    //
-    //     currentKey = displacedKey;
-    //     currentValue = displacedValue;
-    //     currentTable = (currentTable == 1) ? 2 : 1;
-    // }
-
-    return false; // крайне редкий случай
 }
 
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::rehash() {
+    Entries entries;
+    entries.reserve(size);
+    drain(entries);
+    rebuild(static_cast<int>(Policy::grow(capacity)), entries);
+}
 
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::insert(int key, const std::string& value) {
+    return emplace(key, value);
+}
 
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::insert(int key, std::string&& value) {
+    return emplace(key, std::move(value));
+}
 
+template <typename Policy>
+template <typename S>
+bool BasicCuckooHashTable<Policy>::emplace(int key, S&& value) {
+    if (findNode(key) != nullptr) {
+        return false;
+    }
 
-std::string CuckooHashTable::search(int key) const {
-    int pos1 = hash1(key, capacity);
-    if (table1[pos1].isOccupied() && table1[pos1].getKey() == key) {
-        return table1[pos1].getValue();
+    if (static_cast<float>(size + 1) / (capacity * 2) >= 0.5f) {
+        rehash();
     }
 
-    int pos2 = hash2(key, capacity);
-    if (table2[pos2].isOccupied() && table2[pos2].getKey() == key) {
-        return table2[pos2].getValue();
+    CuckooNode node;
+    node.set(key, storeValue(std::string(std::forward<S>(value))));
+    if (place(node) || pushStash(node)) {
+        ++size;
+        return true;
     }
 
-    return "";
+    // Тайник полон: перестроить с новыми зёрнами вместе с оставшейся без места парой
+    Entries entries;
+    entries.reserve(size + 1);
+    drain(entries);
+    entries.push_back(node);
+    rebuild(capacity, entries);
+    return true;
 }
 
-bool CuckooHashTable::remove(int key) {
-    int pos1 = hash1(key, capacity);
-    if (table1[pos1].isOccupied() && table1[pos1].getKey() == key) {
-        table1[pos1].markEmpty();
-        --size;
-        return true;
+template <typename Policy>
+std::string BasicCuckooHashTable<Policy>::search(int key) const {
+    const std::string* value = find(key);
+    return value != nullptr ? *value : "";
+}
+
+template <typename Policy>
+const std::string* BasicCuckooHashTable<Policy>::find(int key) const {
+    const CuckooNode* node = findNode(key);
+    return node != nullptr ? &values[node->getHandle()] : nullptr;
+}
+
+template <typename Policy>
+size_t BasicCuckooHashTable<Policy>::searchBatch(const int* keys, size_t n, const std::string** out) const {
+    int pos1[kBatchChunk];
+    int pos2[kBatchChunk];
+    size_t found = 0;
+
+    for (size_t start = 0; start < n; start += kBatchChunk) {
+        size_t count = std::min(kBatchChunk, n - start);
+
+        for (size_t j = 0; j < count; ++j) {
+            pos1[j] = hash1(keys[start + j]);
+            pos2[j] = hash2(keys[start + j]);
+            __builtin_prefetch(&table1[pos1[j]]);
+            __builtin_prefetch(&table2[pos2[j]]);
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            int key = keys[start + j];
+            const CuckooNode& n1 = table1[pos1[j]];
+            const CuckooNode& n2 = table2[pos2[j]];
+            const CuckooNode* node = nullptr;
+            if (n1.isOccupied() && n1.getKey() == key) {
+                node = &n1;
+            } else if (n2.isOccupied() && n2.getKey() == key) {
+                node = &n2;
+            } else if (stashCount > 0) {
+                int i = findInStash(key);
+                if (i >= 0) node = &stash[i];
+            }
+            const std::string* value = node != nullptr ? &values[node->getHandle()] : nullptr;
+            if (value != nullptr) ++found;
+            out[start + j] = value;
+        }
     }
+    return found;
+}
 
-    int pos2 = hash2(key, capacity);
-    if (table2[pos2].isOccupied() && table2[pos2].getKey() == key) {
-        table2[pos2].markEmpty();
-        --size;
-        return true;
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::remove(int key) {
+    const CuckooNode* found = findNode(key);
+    if (found == nullptr) return false;
+    releaseValue(found->getHandle());
+    --size;
+
+    if (found >= stash && found < stash + kStashSize) {
+        // Последний занятый элемент тайника — на место удалённого
+        int i = static_cast<int>(found - stash);
+        stash[i] = stash[--stashCount];
+        stash[stashCount].markEmpty();
+    } else {
+        const_cast<CuckooNode*>(found)->markEmpty();
     }
+    return true;
+}
 
-    return false;
+template <typename Policy>
+size_t BasicCuckooHashTable<Policy>::memoryUsage() const {
+    return 2 * static_cast<size_t>(capacity) * sizeof(CuckooNode) + values.capacity() * sizeof(std::string) +
+           freeHandles.capacity() * sizeof(uint32_t);
 }
 
-void CuckooHashTable::print() const {
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::print() const {
     std::cout << "Table 1:\n";
     for (int i = 0; i < capacity; ++i) {
         std::cout << "[" << i << "]: ";
         if (table1[i].isOccupied()) {
-            std::cout << table1[i].getKey() << " -> " << table1[i].getValue();
+            std::cout << table1[i].getKey() << " -> " << values[table1[i].getHandle()];
         } else {
             std::cout << "EMPTY";
         }
@@ -187,23 +385,36 @@ void CuckooHashTable::print() const {
     for (int i = 0; i < capacity; ++i) {
         std::cout << "[" << i << "]: ";
         if (table2[i].isOccupied()) {
-            std::cout << table2[i].getKey() << " -> " << table2[i].getValue();
+            std::cout << table2[i].getKey() << " -> " << values[table2[i].getHandle()];
         } else {
             std::cout << "EMPTY";
         }
         std::cout << "\n";
     }
+
+    if (stashCount > 0) {
+        std::cout << "Stash:\n";
+        for (int i = 0; i < stashCount; ++i) {
+            std::cout << "[" << i << "]: " << stash[i].getKey() << " -> " << values[stash[i].getHandle()] << "\n";
+        }
+    }
 }
 
-void CuckooHashTable::clear() {
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::clear() {
     for (int i = 0; i < capacity; ++i) {
         table1[i].markEmpty();
         table2[i].markEmpty();
     }
+    for (int i = 0; i < stashCount; ++i) stash[i].markEmpty();
+    stashCount = 0;
+    values.clear();
+    freeHandles.clear();
     size = 0;
 }
 
-void CuckooHashTable::readFromFile(const std::string& filename) {
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::readFromFile(const std::string& filename) {
     clear();
     std::ifstream in(filename);
     if (!in.is_open()) return;
@@ -218,96 +429,144 @@ void CuckooHashTable::readFromFile(const std::string& filename) {
     in.close();
 }
 
-void CuckooHashTable::writeToFile(const std::string& filename) {
+template <typename Policy>
+void BasicCuckooHashTable<Policy>::writeToFile(const std::string& filename) {
     std::ofstream out(filename);
     for (int i = 0; i < capacity; ++i) {
         if (table1[i].isOccupied()) {
-            out << table1[i].getKey() << " " << table1[i].getValue() << "\n";
+            out << table1[i].getKey() << " " << values[table1[i].getHandle()] << "\n";
         }
         if (table2[i].isOccupied()) {
-            out << table2[i].getKey() << " " << table2[i].getValue() << "\n";
+            out << table2[i].getKey() << " " << values[table2[i].getHandle()] << "\n";
         }
     }
+    for (int i = 0; i < stashCount; ++i) {
+        out << stash[i].getKey() << " " << values[stash[i].getHandle()] << "\n";
+    }
     out.close();
 }
 
-bool CuckooHashTable::serializeToBinary(const std::string& filename) const {
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::serializeToBinary(const std::string& filename) const {
     std::ofstream out(filename, std::ios::binary);
     if (!out.is_open()) return false;
 
-    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
-    out.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
-
-    for (int i = 0; i < capacity; ++i) {
-        if (table1[i].isOccupied()) {
-            int key = table1[i].getKey();
-            out.write(reinterpret_cast<const char*>(&key), sizeof(key));
-
-            const std::string& value = table1[i].getValue();
-            int len = static_cast<int>(value.size());
-            out.write(reinterpret_cast<const char*>(&len), sizeof(len));
-            if (len > 0) out.write(value.data(), len);
-        }
-        if (table2[i].isOccupied()) {
-            int key = table2[i].getKey();
-            out.write(reinterpret_cast<const char*>(&key), sizeof(key));
-
-            const std::string& value = table2[i].getValue();
-            int len = static_cast<int>(value.size());
-            out.write(reinterpret_cast<const char*>(&len), sizeof(len));
-            if (len > 0) out.write(value.data(), len);
-        }
-    }
-
+    // Слоты пишутся как есть, но дескрипторы перенумерованы по порядку
+    // обхода table1, table2, stash — пул в файле плотный
+    std::vector<CuckooNode> nodes(2 * static_cast<size_t>(capacity) + stashCount);
+    std::vector<uint64_t> offsets;
+    offsets.reserve(size + 1);
+    std::string bytes;
+    uint32_t next = 0;
+    auto take = [&](const CuckooNode& node, CuckooNode& dst) {
+        if (!node.isOccupied()) return;
+        dst.set(node.getKey(), next++);
+        offsets.push_back(bytes.size());
+        bytes += values[node.getHandle()];
+    };
+    for (int i = 0; i < capacity; ++i) take(table1[i], nodes[i]);
+    for (int i = 0; i < capacity; ++i) take(table2[i], nodes[capacity + i]);
+    for (int i = 0; i < stashCount; ++i) take(stash[i], nodes[2 * capacity + i]);
+    offsets.push_back(bytes.size());
+
+    cuckoo_snapshot::Header header{};
+    std::memcpy(header.magic, cuckoo_snapshot::kMagic, sizeof(header.magic));
+    header.policyId = Policy::kId;
+    header.capacity = static_cast<uint32_t>(capacity);
+    header.size = static_cast<uint32_t>(size);
+    header.stashCount = static_cast<uint32_t>(stashCount);
+    header.seed1 = seed1;
+    header.seed2 = seed2;
+    header.seedCounter = seedCounter;
+    header.bytes = bytes.size();
+
+    uint64_t sum = cuckoo_snapshot::kChecksumSeed;
+    sum = cuckoo_snapshot::checksum(sum, nodes.data(), nodes.size() * sizeof(CuckooNode));
+    sum = cuckoo_snapshot::checksum(sum, offsets.data(), offsets.size() * sizeof(uint64_t));
+    sum = cuckoo_snapshot::checksum(sum, bytes.data(), bytes.size());
+    header.checksum = sum;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(CuckooNode));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(bytes.data(), bytes.size());
     out.close();
-    return true;
+    return static_cast<bool>(out);
 }
 
-bool CuckooHashTable::deserializeFromBinary(const std::string& filename) {
+// Загрузка без хэширования: слоты копируются на свои места. Дескрипторы
+// обязаны идти подряд в порядке обхода — это проверяет и заполненность.
+// false — файла нет, он повреждён или от другой Policy; таблица не меняется.
+template <typename Policy>
+bool BasicCuckooHashTable<Policy>::deserializeFromBinary(const std::string& filename) {
     std::ifstream in(filename, std::ios::binary);
     if (!in.is_open()) return false;
 
-    clear();
-    delete[] table1;
-    delete[] table2;
-
-    int newSize, newCapacity;
-    in.read(reinterpret_cast<char*>(&newSize), sizeof(newSize));
-    in.read(reinterpret_cast<char*>(&newCapacity), sizeof(newCapacity));
-
-    size = 0;
-    capacity = newCapacity;
-    table1 = new CuckooNode[capacity];
-    table2 = new CuckooNode[capacity];
-
-    for (int i = 0; i < newSize; ++i) {
-        int key;
-        in.read(reinterpret_cast<char*>(&key), sizeof(key));
-
-        int len;
-        in.read(reinterpret_cast<char*>(&len), sizeof(len));
-
-        std::string value;
-        if (len > 0) {
-            value.resize(len);
-            in.read(&value[0], len);
-        }
-
-        // Прямое размещение (как в оригинале при сохранении)
-        int pos1 = hash1(key, capacity);
-        if (!table1[pos1].isOccupied()) {
-            table1[pos1].setKey(key);
-            table1[pos1].setValue(value);
-            table1[pos1].markOccupied();
-        } else {
-            int pos2 = hash2(key, capacity);
-            table2[pos2].setKey(key);
-            table2[pos2].setValue(value);
-            table2[pos2].markOccupied();
+    cuckoo_snapshot::Header header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    bool valid = std::memcmp(header.magic, cuckoo_snapshot::kMagic, sizeof(header.magic)) == 0 &&
+                 header.policyId == Policy::kId && header.capacity > 0 && header.capacity <= INT32_MAX / 2 &&
+                 Policy::roundCapacity(header.capacity) == header.capacity && header.stashCount <= kStashSize &&
+                 header.size <= 2 * header.capacity + header.stashCount;
+    if (!valid) return false;
+
+    const int newCapacity = static_cast<int>(header.capacity);
+    const int newStash = static_cast<int>(header.stashCount);
+    const size_t nodeCount = 2 * static_cast<size_t>(newCapacity) + newStash;
+    const size_t offsetCount = static_cast<size_t>(header.size) + 1;
+
+    // Длина файла должна сойтись с заголовком до выделения памяти:
+    // повреждённый заголовок не должен заказать гигабайты
+    const uint64_t fixed = sizeof(header) + nodeCount * sizeof(CuckooNode) + offsetCount * sizeof(uint64_t);
+    in.seekg(0, std::ios::end);
+    const uint64_t length = static_cast<uint64_t>(in.tellg());
+    if (!in || length < fixed || length - fixed != header.bytes) return false;
+    in.seekg(sizeof(header));
+
+    std::vector<CuckooNode> nodes(nodeCount);
+    std::vector<uint64_t> offsets(offsetCount);
+    if (!in.read(reinterpret_cast<char*>(nodes.data()), nodes.size() * sizeof(CuckooNode)) ||
+        !in.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t))) {
+        return false;
+    }
+    if (offsets[0] != 0 || offsets[header.size] != header.bytes) return false;
+    std::string bytes(header.bytes, '\0');
+    if (header.bytes > 0 && !in.read(&bytes[0], header.bytes)) return false;
+
+    uint64_t sum = cuckoo_snapshot::kChecksumSeed;
+    sum = cuckoo_snapshot::checksum(sum, nodes.data(), nodes.size() * sizeof(CuckooNode));
+    sum = cuckoo_snapshot::checksum(sum, offsets.data(), offsets.size() * sizeof(uint64_t));
+    sum = cuckoo_snapshot::checksum(sum, bytes.data(), bytes.size());
+    if (sum != header.checksum) return false;
+
+    uint32_t next = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!nodes[i].isOccupied()) {
+            if (i >= 2 * static_cast<size_t>(newCapacity)) return false; // дыра в тайнике
+            continue;
         }
-        ++size;
+        if (nodes[i].getHandle() != next++) return false;
+    }
+    if (next != header.size) return false;
+    for (uint32_t h = 0; h < header.size; ++h) {
+        if (offsets[h] > offsets[h + 1]) return false;
     }
 
-    in.close();
+    allocate(newCapacity);
+    std::copy(nodes.begin(), nodes.begin() + newCapacity, table1);
+    std::copy(nodes.begin() + newCapacity, nodes.begin() + 2 * newCapacity, table2);
+    std::copy(nodes.begin() + 2 * newCapacity, nodes.end(), stash);
+    stashCount = newStash;
+    size = static_cast<int>(header.size);
+    seed1 = header.seed1;
+    seed2 = header.seed2;
+    seedCounter = header.seedCounter;
+
+    values.resize(header.size);
+    for (uint32_t h = 0; h < header.size; ++h) values[h].assign(bytes, offsets[h], offsets[h + 1] - offsets[h]);
+    freeHandles.clear();
     return true;
 }
+
+template class BasicCuckooHashTable<PrimeModPolicy>;
+template class BasicCuckooHashTable<Pow2MixPolicy>;
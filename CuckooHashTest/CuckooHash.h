@@ -1,47 +1,135 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <utility>
+#include <vector>
+#include "../TwiceHashedTest/HashPolicy.h"
 
+// Слот таблицы: ключ и дескриптор значения в пуле таблицы (8 байт).
+// Строки лежат вне слотов, поэтому вытеснение переносит только слот.
 class CuckooNode {
 private:
     int key;
-    std::string value;
-    bool occupied;
+    uint32_t handle;
 
 public:
+    static constexpr uint32_t kNoValue = UINT32_MAX;
+
     CuckooNode();
-    
+
     int getKey() const;
-    const std::string& getValue() const;
+    uint32_t getHandle() const;
     bool isOccupied() const;
 
-    void setKey(int k);
-    void setValue(const std::string& v);
-    void markOccupied();
+    void set(int k, uint32_t h);
     void markEmpty();
 };
 
-class CuckooHashTable {
+// Как insert ищет место при занятых кандидатах:
+//   RandomWalk — жадное вытеснение с переносом пары на каждом шаге;
+//   Bfs — сначала поиск в ширину кратчайшего пути до свободного слота
+//         (не длиннее kMaxBfsDepth), затем сдвиг пар вдоль пути с конца.
+enum class CuckooInsertMode { RandomWalk, Bfs };
+
+// Policy задаёт ёмкости и индексы обеих таблиц (см. HashPolicy.h).
+// Реализация и инстанциации для PrimeModPolicy и Pow2MixPolicy — в CuckooHash.cpp.
+template <typename Policy = PrimeModPolicy>
+class BasicCuckooHashTable {
+public:
+    // Пары, не уложившиеся ни в одну таблицу; полная перестройка — только
+    // когда тайник переполнен
+    static constexpr int kStashSize = 4;
+
 private:
     CuckooNode* table1;
     CuckooNode* table2;
-    int size;
+    int size; // вместе с тайником
     int capacity;
+    CuckooNode stash[kStashSize];
+    int stashCount; // занятые stash[0..stashCount)
+    // Пул значений: слот хранит индекс строки; освобождённые индексы
+    // переиспользуются. Перестройка таблиц пул не трогает.
+    std::vector<std::string> values;
+    std::vector<uint32_t> freeHandles;
+    // Зёрна двух хэш-функций; меняются при каждой перестройке по неудаче
+    uint64_t seed1;
+    uint64_t seed2;
+    uint64_t seedCounter;
+    CuckooInsertMode insertMode;
+
+    // Семейство функций: splitmix64 от ключа, смешанного с зерном.
+    // Зёрна независимы, поэтому корзины обеих таблиц не коррелируют.
+    static size_t keyHash(int key, uint64_t seed) {
+        return static_cast<size_t>(Pow2MixPolicy::mix2(static_cast<uint32_t>(key) ^ seed));
+    }
+    int hash1(int key) const { return static_cast<int>(Policy::index(keyHash(key, seed1), capacity)); }
+    int hash2(int key) const { return static_cast<int>(Policy::index(keyHash(key, seed2), capacity)); }
 
+    using Entries = std::vector<CuckooNode>;
+
+    uint32_t storeValue(std::string&& value);
+    void releaseValue(uint32_t handle);
+
+    void reseed();
+    void allocate(int newCapacity);
+    // Предел шагов вытеснения для текущей ёмкости
+    int maxLoop() const;
+    // Размещает слот с вытеснениями. false — найден цикл или исчерпан
+    // предел; тогда node — слот, оставшийся без места.
+    bool place(CuckooNode& node);
+    // Путь без изменений таблицы до его нахождения; при неудаче таблица не тронута
+    bool placeBfs(const CuckooNode& node);
+    CuckooNode& nodeAt(int table, int pos) { return table == 1 ? table1[pos] : table2[pos]; }
+    // Слот ключа в таблицах или тайнике; nullptr — ключа нет
+    const CuckooNode* findNode(int key) const;
+    // Индекс в stash или -1
+    int findInStash(int key) const;
+    bool pushStash(const CuckooNode& node);
+    void drain(Entries& out) const;
+    // Перестраивает таблицу из entries с новыми зёрнами; после kMaxReseeds
+    // неудач подряд ёмкость растёт. Ни одна пара не теряется.
+    void rebuild(int newCapacity, Entries& entries);
     void rehash();
-    bool insertHelper(int key, const std::string& value, int tableNum, int depth);
+    // Общая часть обеих insert: одна проверка ключа, затем размещение.
+    // Значение копируется или перемещается в пул только для нового ключа.
+    template <typename S>
+    bool emplace(int key, S&& value);
 
 public:
-    CuckooHashTable(int initialCapacity = 11);
-    ~CuckooHashTable();
+    // Неудачных перестроек с новыми зёрнами до роста ёмкости
+    static constexpr int kMaxReseeds = 4;
+    // Предел длины пути вытеснения в режиме Bfs
+    static constexpr int kMaxBfsDepth = 128;
+
+    BasicCuckooHashTable(int initialCapacity = 11);
+    ~BasicCuckooHashTable();
 
+    BasicCuckooHashTable(const BasicCuckooHashTable&) = delete;
+    BasicCuckooHashTable& operator=(const BasicCuckooHashTable&) = delete;
+
+    // false только для уже существующего ключа
     bool insert(int key, const std::string& value);
+    bool insert(int key, std::string&& value);
     std::string search(int key) const;
+    // Значение без копирования или nullptr; действительно до изменения таблицы
+    const std::string* find(int key) const;
+    // Пакетный поиск: out[i] — значение keys[i] или nullptr. Оба кандидата
+    // каждого ключа запрашиваются (prefetch) до проверки первого из них.
+    // Возвращает число найденных ключей.
+    static constexpr size_t kBatchChunk = 64;
+    size_t searchBatch(const int* keys, size_t n, const std::string** out) const;
     bool remove(int key);
 
     int getSize() const { return size; }
     bool isEmpty() const { return size == 0; }
     int getCapacity() const { return capacity; }
+    int getStashSize() const { return stashCount; }
+    // Байты слотов и пула значений (без содержимого длинных строк)
+    size_t memoryUsage() const;
+
+    void setInsertMode(CuckooInsertMode mode) { insertMode = mode; }
+    CuckooInsertMode getInsertMode() const { return insertMode; }
 
     void print() const;
     void clear();
@@ -49,10 +137,18 @@ public:
     void readFromFile(const std::string& filename);
     void writeToFile(const std::string& filename);
 
+    // Снимок с раскладкой слотов, зёрнами и контрольной суммой (формат —
+    // в CuckooHash.cpp). Загрузка копирует слоты на прежние места без
+    // хэширования; при ошибке возвращает false и не меняет таблицу.
     bool serializeToBinary(const std::string& filename) const;
     bool deserializeFromBinary(const std::string& filename);
 
     // Для тестов
     const CuckooNode* getTable1() const { return table1; }
     const CuckooNode* getTable2() const { return table2; }
+    const CuckooNode* getStash() const { return stash; }
+    const std::string& valueOf(const CuckooNode& node) const { return values[node.getHandle()]; }
+    std::pair<int, int> getCandidates(int key) const { return {hash1(key), hash2(key)}; }
 };
+
+using CuckooHashTable = BasicCuckooHashTable<>;
@@ -4,8 +4,16 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/chrono.hpp>
 #include "CuckooHash.h"
+#include "BucketCuckooHash.h"
+#include "ConcurrentCuckooHash.h"
+#include "CuckooFilter.h"
 #include <random>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdio>
 
 BOOST_AUTO_TEST_CASE(bench_insert_random) {
     CuckooHashTable ht;
@@ -96,4 +104,300 @@ BOOST_AUTO_TEST_CASE(bench_mixed) {
     std::cout << "[BENCH] Mixed operations (" << OPS << " ops): " << dur.count() << " ms\n";
     std::cout << "       Final size: " << ht.getSize() << "\n";
 }
+
+template <typename Table>
+void benchSequential(const char* name, int count, int stride) {
+    Table ht;
+    int failed = 0;
+
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) failed += !ht.insert(i * stride, "val");
+    auto mid = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) ht.search(i * stride);
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    std::cout << "[BENCH] " << name << " stride " << stride << ": insert " << ms(start, mid)
+              << " ms, search " << ms(mid, end) << " ms, failed inserts " << failed
+              << ", capacity " << ht.getCapacity() << "\n";
+}
+
+BOOST_AUTO_TEST_CASE(bench_sequential_keys) {
+    const int COUNT = 20000;
+    for (int stride : {1, 64}) {
+        benchSequential<BasicCuckooHashTable<PrimeModPolicy>>("Prime/mod", COUNT, stride);
+        benchSequential<BasicCuckooHashTable<Pow2MixPolicy>>("Pow2/mix ", COUNT, stride);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bench_search_batch) {
+    const int SIZE = 500000;
+    const size_t LOOKUPS = 2000000;
+    BasicCuckooHashTable<Pow2MixPolicy> ht;
+    for (int i = 0; i < SIZE; ++i) ht.insert(i, "val");
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dis(0, 2 * SIZE);
+    std::vector<int> keys(LOOKUPS);
+    for (auto& k : keys) k = dis(gen);
+    std::vector<const std::string*> out(LOOKUPS);
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+
+    size_t hits = 0;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (size_t j = 0; j < LOOKUPS; ++j) hits += !ht.search(keys[j]).empty();
+    auto end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] search() one by one (" << LOOKUPS << " lookups): " << ms(start, end)
+              << " ms, hits " << hits << "\n";
+
+    for (size_t batch : {1, 16, 64, 256, 1024}) {
+        hits = 0;
+        start = boost::chrono::high_resolution_clock::now();
+        for (size_t j = 0; j < LOOKUPS; j += batch) {
+            size_t n = std::min(batch, LOOKUPS - j);
+            hits += ht.searchBatch(keys.data() + j, n, out.data() + j);
+        }
+        end = boost::chrono::high_resolution_clock::now();
+        std::cout << "[BENCH] searchBatch batch " << batch << ": " << ms(start, end)
+                  << " ms, hits " << hits << "\n";
+    }
+}
+
+template <typename Table>
+void benchBuckets(const char* name, const std::vector<int>& keys, const std::vector<int>& lookups,
+                  size_t slotsPerCapacity, size_t memory(const Table&)) {
+    Table ht;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int k : keys) ht.insert(k, "val");
+    auto mid = boost::chrono::high_resolution_clock::now();
+    size_t hits = 0;
+    for (int k : lookups) hits += !ht.search(k).empty();
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    double slots = static_cast<double>(ht.getCapacity()) * slotsPerCapacity;
+    std::cout << "[BENCH] " << name << ": insert " << ms(start, mid) << " ms, search " << ms(mid, end)
+              << " ms, hits " << hits << ", load " << ht.getSize() / slots << ", bytes/key "
+              << static_cast<double>(memory(ht)) / ht.getSize() << "\n";
+}
+
+BOOST_AUTO_TEST_CASE(bench_bucket_cuckoo) {
+    const int SIZE = 460000; // ~88% от 2^19 слотов
+    std::mt19937 gen(11);
+    std::vector<int> keys(SIZE), lookups(SIZE);
+    for (auto& k : keys) k = static_cast<int>(gen());
+    for (int i = 0; i < SIZE; ++i) lookups[i] = i % 2 ? keys[i] : static_cast<int>(gen());
+
+    // У классической таблицы getCapacity() — размер одной из двух таблиц
+    using Classic = BasicCuckooHashTable<Pow2MixPolicy>;
+    benchBuckets<Classic>("Cuckoo 2x1      ", keys, lookups, 2, [](const Classic& t) { return t.memoryUsage(); });
+    benchBuckets<BasicBucketCuckooHashTable<4, 2>>("Bucket 4 ways/2h", keys, lookups, 1,
+                                                   [](const BasicBucketCuckooHashTable<4, 2>& t) { return t.memoryUsage(); });
+    benchBuckets<BasicBucketCuckooHashTable<8, 2>>("Bucket 8 ways/2h", keys, lookups, 1,
+                                                   [](const BasicBucketCuckooHashTable<8, 2>& t) { return t.memoryUsage(); });
+    benchBuckets<BasicBucketCuckooHashTable<4, 3>>("Bucket 4 ways/3h", keys, lookups, 1,
+                                                   [](const BasicBucketCuckooHashTable<4, 3>& t) { return t.memoryUsage(); });
+}
+
+// Задержка отдельных вставок: среднее, 99.9-й перцентиль и максимум
+void benchInsertLatency(const char* name, CuckooInsertMode mode, const std::vector<int>& keys) {
+    BasicCuckooHashTable<Pow2MixPolicy> ht(1 << 20); // без роста: меряется только вытеснение
+    ht.setInsertMode(mode);
+    std::vector<double> micros;
+    micros.reserve(keys.size());
+    for (int k : keys) {
+        auto start = boost::chrono::high_resolution_clock::now();
+        ht.insert(k, "a value long enough to be heap allocated");
+        auto end = boost::chrono::high_resolution_clock::now();
+        micros.push_back(boost::chrono::duration_cast<boost::chrono::nanoseconds>(end - start).count() / 1000.0);
+    }
+    double total = 0;
+    for (double m : micros) total += m;
+    std::sort(micros.begin(), micros.end());
+    std::cout << "[BENCH] Insert " << name << ": mean " << total / micros.size() << " us, p99.9 "
+              << micros[micros.size() * 999 / 1000] << " us, max " << micros.back() << " us\n";
+}
+
+BOOST_AUTO_TEST_CASE(bench_bfs_insert) {
+    std::mt19937 gen(13);
+    std::vector<int> keys(1000000); // загрузка ~0.48
+    for (auto& k : keys) k = static_cast<int>(gen());
+    benchInsertLatency("random walk", CuckooInsertMode::RandomWalk, keys);
+    benchInsertLatency("BFS path   ", CuckooInsertMode::Bfs, keys);
+}
+
+// CuckooHashTable под одним мьютексом — точка отсчёта для многопоточного теста
+class LockedCuckooHashTable {
+private:
+    std::mutex lock;
+    BasicCuckooHashTable<Pow2MixPolicy> table;
+
+public:
+    bool insert(int key, const std::string& value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.insert(key, value);
+    }
+    bool remove(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.remove(key);
+    }
+    std::string search(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.search(key);
+    }
+};
+
+template <typename Table>
+double benchCuckooThroughput(Table& ht, int threads, int readPercent, int opsPerThread, int keys) {
+    std::vector<std::thread> workers;
+    std::atomic<size_t> hits(0);
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 gen(100 + t);
+            std::uniform_int_distribution<> key_dis(0, keys - 1);
+            std::uniform_int_distribution<> op_dis(0, 99);
+            size_t local = 0;
+            for (int i = 0; i < opsPerThread; ++i) {
+                int key = key_dis(gen);
+                int op = op_dis(gen);
+                if (op < readPercent) local += !ht.search(key).empty();
+                else if (op % 2 == 0) ht.insert(key, "val");
+                else ht.remove(key);
+            }
+            hits += local;
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = boost::chrono::high_resolution_clock::now();
+    double sec = boost::chrono::duration_cast<boost::chrono::microseconds>(end - start).count() / 1e6;
+    return threads * static_cast<double>(opsPerThread) / sec / 1e6;
+}
+
+BOOST_AUTO_TEST_CASE(bench_concurrent_cuckoo) {
+    const int OPS = 500000;
+    const int KEYS = 200000;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "[BENCH] Cuckoo 90/10 read/write (" << OPS << " ops/thread, " << hw << " hw threads)\n";
+    for (int threads = 1; threads <= static_cast<int>(std::max(4u, hw)) && threads <= 64; threads *= 2) {
+        LockedCuckooHashTable locked;
+        ConcurrentCuckooHashTable concurrent;
+        for (int i = 0; i < KEYS; i += 2) {
+            locked.insert(i, "val");
+            concurrent.insert(i, "val");
+        }
+        double a = benchCuckooThroughput(locked, threads, 90, OPS, KEYS);
+        double b = benchCuckooThroughput(concurrent, threads, 90, OPS, KEYS);
+        std::cout << "[BENCH] " << threads << " threads: one mutex " << a << " Mops/s, striped + optimistic reads "
+                  << b << " Mops/s\n";
+    }
+}
+
+// Длинные значения: вытеснение и рост не должны копировать строки
+BOOST_AUTO_TEST_CASE(bench_long_values) {
+    const int SIZE = 500000;
+    std::mt19937 gen(17);
+    std::vector<int> keys(SIZE);
+    for (auto& k : keys) k = static_cast<int>(gen());
+    const std::string value(100, 'x');
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    for (CuckooInsertMode mode : {CuckooInsertMode::RandomWalk, CuckooInsertMode::Bfs}) {
+        BasicCuckooHashTable<Pow2MixPolicy> ht;
+        ht.setInsertMode(mode);
+        auto start = boost::chrono::high_resolution_clock::now();
+        for (int k : keys) ht.insert(k, value);
+        auto mid = boost::chrono::high_resolution_clock::now();
+        for (int k : keys) ht.insert(k, value); // только проверка дубликатов
+        auto end = boost::chrono::high_resolution_clock::now();
+        std::cout << "[BENCH] 100-byte values, " << (mode == CuckooInsertMode::Bfs ? "BFS " : "walk")
+                  << ": insert " << ms(start, mid) << " ms, duplicate inserts " << ms(mid, end) << " ms\n";
+    }
+}
+
+// Отсев отсутствующих ключей перед медленным хранилищем
+BOOST_AUTO_TEST_CASE(bench_cuckoo_filter) {
+    const int SIZE = 1000000;
+    const int LOOKUPS = 2000000;
+    BasicCuckooHashTable<Pow2MixPolicy> table;
+    CuckooFilter filter(SIZE, 0.001);
+    CuckooFilter8 filter8(SIZE, 0.03);
+    for (int i = 0; i < SIZE; ++i) {
+        table.insert(i * 2, "val");
+        filter.insert(i * 2);
+        filter8.insert(i * 2);
+    }
+
+    std::mt19937 gen(21);
+    std::vector<int> keys(LOOKUPS);
+    for (auto& k : keys) k = static_cast<int>(gen() % (4 * SIZE));
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    size_t hits = 0;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int k : keys) hits += !table.search(k).empty();
+    auto end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] CuckooHashTable search: " << ms(start, end) << " ms, hits " << hits << ", bytes/key "
+              << static_cast<double>(table.memoryUsage()) / SIZE << "\n";
+
+    hits = 0;
+    start = boost::chrono::high_resolution_clock::now();
+    for (int k : keys) hits += filter.contains(k);
+    end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] CuckooFilter (" << filter.getFingerprintBits() << " bit) contains: " << ms(start, end)
+              << " ms, positives " << hits << ", bytes/key " << static_cast<double>(filter.memoryUsage()) / SIZE
+              << "\n";
+
+    hits = 0;
+    start = boost::chrono::high_resolution_clock::now();
+    for (int k : keys) hits += filter8.contains(k);
+    end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] CuckooFilter8 (" << filter8.getFingerprintBits() << " bit, fpr <= " << filter8.achievedFpr()
+              << ") contains: " << ms(start, end) << " ms, positives " << hits << ", bytes/key " << static_cast<double>(filter8.memoryUsage()) / SIZE
+              << "\n";
+}
+
+// Загрузка снимка против повторной вставки тех же пар (как грузили раньше)
+BOOST_AUTO_TEST_CASE(bench_snapshot_load) {
+    const int SIZE = 1000000;
+    std::mt19937 gen(23);
+    BasicCuckooHashTable<Pow2MixPolicy> ht;
+    std::vector<std::pair<int, std::string>> pairs;
+    pairs.reserve(SIZE);
+    for (int i = 0; i < SIZE; ++i) {
+        int k = static_cast<int>(gen());
+        if (ht.insert(k, "value" + std::to_string(i))) pairs.emplace_back(k, "value" + std::to_string(i));
+    }
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    const std::string binfile = "bench_cuckoo_snapshot.bin";
+    auto start = boost::chrono::high_resolution_clock::now();
+    ht.serializeToBinary(binfile);
+    auto mid = boost::chrono::high_resolution_clock::now();
+    BasicCuckooHashTable<Pow2MixPolicy> loaded;
+    loaded.deserializeFromBinary(binfile);
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    BasicCuckooHashTable<Pow2MixPolicy> reinserted(ht.getCapacity());
+    auto reStart = boost::chrono::high_resolution_clock::now();
+    for (auto& p : pairs) reinserted.insert(p.first, p.second);
+    auto reEnd = boost::chrono::high_resolution_clock::now();
+
+    std::cout << "[BENCH] Snapshot " << loaded.getSize() << " entries: save " << ms(start, mid) << " ms, load "
+              << ms(mid, end) << " ms; re-insert " << ms(reStart, reEnd) << " ms\n";
+    std::remove(binfile.c_str());
+}
 #endif
\ No newline at end of file
@@ -3,11 +3,18 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "CuckooHash.h"
+#include "BucketCuckooHash.h"
+#include "ConcurrentCuckooHash.h"
+#include "CuckooFilter.h"
 #include <fstream>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 #include <random>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <iterator>
 
 std::string captureOutput(std::function<void()> func) {
     std::ostringstream oss;
@@ -215,4 +222,583 @@ BOOST_AUTO_TEST_CASE(test_rehash_behavior) {
     ht.insert(extra_key, "extra");
     BOOST_CHECK(ht.search(extra_key) != "");
 }
+
+BOOST_AUTO_TEST_CASE(test_pow2_mix_policy) {
+    BasicCuckooHashTable<Pow2MixPolicy> ht;
+    BOOST_CHECK((ht.getCapacity() & (ht.getCapacity() - 1)) == 0);
+
+    std::vector<int> inserted;
+    for (int k = -2000; k < 2000; ++k) {
+        if (ht.insert(k, "v" + std::to_string(k))) inserted.push_back(k);
+    }
+    BOOST_CHECK(static_cast<size_t>(ht.getSize()) == inserted.size());
+    for (int k : inserted) BOOST_REQUIRE(ht.search(k) == "v" + std::to_string(k));
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_keys) {
+    CuckooHashTable ht;
+    std::vector<int> inserted;
+    for (int k = -100; k < 0; ++k) {
+        if (ht.insert(k, "neg")) inserted.push_back(k);
+    }
+    BOOST_CHECK(!inserted.empty());
+    for (int k : inserted) BOOST_CHECK(ht.search(k) == "neg");
+    for (int k : inserted) BOOST_CHECK(ht.remove(k));
+    BOOST_CHECK(ht.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(test_search_batch) {
+    CuckooHashTable ht;
+    for (int i = 0; i < 200; ++i) ht.insert(i * 5, "v" + std::to_string(i));
+
+    std::vector<int> keys;
+    for (int i = 0; i < 150; ++i) keys.push_back(i * 5 + (i % 3 == 0 ? 1 : 0));
+    std::vector<const std::string*> out(keys.size());
+
+    size_t found = ht.searchBatch(keys.data(), keys.size(), out.data());
+    BOOST_CHECK_EQUAL(found, 100u);
+    for (size_t j = 0; j < keys.size(); ++j) {
+        if (out[j] != nullptr) BOOST_CHECK(*out[j] == ht.search(keys[j]));
+        else BOOST_CHECK(ht.search(keys[j]) == "");
+        BOOST_CHECK(ht.find(keys[j]) == out[j]); // find() — тот же слот пула, без копии
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bucket_cuckoo_basic) {
+    BucketCuckooHashTable ht;
+    BOOST_CHECK(ht.insert(10, "ten"));
+    BOOST_CHECK(ht.insert(-20, "minus twenty"));
+    BOOST_CHECK(!ht.insert(10, "again")); // дубликат — false
+    BOOST_CHECK(ht.search(10) == "ten");
+    BOOST_CHECK(ht.search(-20) == "minus twenty");
+    BOOST_CHECK(ht.find(30) == nullptr);
+    BOOST_CHECK_EQUAL(ht.getSize(), 2u);
+
+    BOOST_CHECK(ht.remove(10));
+    BOOST_CHECK(!ht.remove(10));
+    BOOST_CHECK(!ht.contains(10));
+    BOOST_CHECK_EQUAL(ht.getSize(), 1u);
+
+    ht.clear();
+    BOOST_CHECK(ht.isEmpty());
+    BOOST_CHECK(ht.insert(10, "ten"));
+}
+
+template <typename Table>
+void checkBucketLoad(size_t capacity, float load) {
+    Table ht(capacity);
+    const size_t slots = ht.getCapacity();
+    const size_t count = static_cast<size_t>(slots * load);
+    std::mt19937 gen(5);
+    std::vector<int> keys;
+    while (keys.size() < count) {
+        int k = static_cast<int>(gen());
+        if (ht.insert(k, std::to_string(k))) keys.push_back(k);
+    }
+    // Загрузка держится без роста таблицы
+    BOOST_CHECK_EQUAL(ht.getCapacity(), slots);
+    BOOST_CHECK(ht.loadFactor() >= load - 0.01f);
+    for (int k : keys) BOOST_REQUIRE(ht.search(k) == std::to_string(k));
+}
+
+BOOST_AUTO_TEST_CASE(test_bucket_cuckoo_high_load) {
+    checkBucketLoad<BasicBucketCuckooHashTable<4, 2>>(1 << 14, 0.9f);
+    checkBucketLoad<BasicBucketCuckooHashTable<8, 2>>(1 << 14, 0.95f);
+    checkBucketLoad<BasicBucketCuckooHashTable<4, 3>>(1 << 14, 0.95f);
+    checkBucketLoad<BasicBucketCuckooHashTable<4, 2, PrimeModPolicy>>(1 << 14, 0.9f);
+}
+
+BOOST_AUTO_TEST_CASE(test_bucket_cuckoo_growth) {
+    BasicBucketCuckooHashTable<8, 2> ht(8);
+    const int COUNT = 50000;
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(ht.insert(i * 64, "v" + std::to_string(i)));
+    BOOST_CHECK_EQUAL(ht.getSize(), static_cast<size_t>(COUNT));
+    BOOST_CHECK(ht.loadFactor() > 0.4f);
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(ht.search(i * 64) == "v" + std::to_string(i));
+    for (int i = 0; i < COUNT; i += 2) BOOST_REQUIRE(ht.remove(i * 64));
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE_EQUAL(ht.contains(i * 64), i % 2 == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_insert_never_drops) {
+    // Кратные ёмкости ключи: при hash2 = (key / c) % c они сталкивались в обеих таблицах
+    CuckooHashTable ht(11);
+    const int COUNT = 5000;
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(ht.insert(i * 11 * 11, "v" + std::to_string(i)));
+    BOOST_CHECK_EQUAL(ht.getSize(), COUNT);
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(ht.search(i * 11 * 11) == "v" + std::to_string(i));
+
+    BasicCuckooHashTable<Pow2MixPolicy> random;
+    std::mt19937 gen(3);
+    std::vector<int> keys;
+    for (int i = 0; i < 100000; ++i) {
+        int k = static_cast<int>(gen());
+        if (random.insert(k, std::to_string(k))) keys.push_back(k);
+    }
+    BOOST_CHECK_EQUAL(static_cast<size_t>(random.getSize()), keys.size());
+    for (int k : keys) BOOST_REQUIRE(random.search(k) == std::to_string(k));
+}
+
+BOOST_AUTO_TEST_CASE(test_insert_keeps_capacity_on_reseed) {
+    // До порога загрузки ёмкость не растёт, даже если были перестройки по циклу
+    CuckooHashTable ht(1009);
+    const int capacity = ht.getCapacity();
+    for (int i = 0; i < capacity - 1; ++i) BOOST_REQUIRE(ht.insert(i * 7919, "x"));
+    BOOST_CHECK_EQUAL(ht.getCapacity(), capacity);
+    BOOST_CHECK_EQUAL(ht.getSize(), capacity - 1);
+    for (int i = 0; i < capacity - 1; ++i) BOOST_REQUIRE(ht.search(i * 7919) == "x");
+}
+
+BOOST_AUTO_TEST_CASE(test_bfs_insert) {
+    CuckooHashTable walk;
+    CuckooHashTable bfs;
+    bfs.setInsertMode(CuckooInsertMode::Bfs);
+    BOOST_CHECK(bfs.getInsertMode() == CuckooInsertMode::Bfs);
+
+    std::mt19937 gen(9);
+    std::vector<int> keys;
+    for (int i = 0; i < 50000; ++i) {
+        int k = static_cast<int>(gen() % 1000000);
+        bool inserted = bfs.insert(k, "v" + std::to_string(k));
+        BOOST_REQUIRE_EQUAL(inserted, walk.insert(k, "v" + std::to_string(k)));
+        if (inserted) keys.push_back(k);
+    }
+    BOOST_CHECK_EQUAL(static_cast<size_t>(bfs.getSize()), keys.size());
+    BOOST_CHECK_EQUAL(bfs.getSize(), walk.getSize());
+    for (int k : keys) BOOST_REQUIRE(bfs.search(k) == "v" + std::to_string(k));
+
+    for (size_t i = 0; i < keys.size(); i += 3) BOOST_REQUIRE(bfs.remove(keys[i]));
+    for (size_t i = 0; i < keys.size(); ++i) BOOST_REQUIRE_EQUAL(bfs.search(keys[i]).empty(), i % 3 == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_bfs_insert_collisions) {
+    CuckooHashTable ht(11);
+    ht.setInsertMode(CuckooInsertMode::Bfs);
+    for (int i = 0; i < 3000; ++i) BOOST_REQUIRE(ht.insert(i * 121, std::to_string(i)));
+    BOOST_CHECK_EQUAL(ht.getSize(), 3000);
+    for (int i = 0; i < 3000; ++i) BOOST_REQUIRE(ht.search(i * 121) == std::to_string(i));
+}
+
+BOOST_AUTO_TEST_CASE(test_stash) {
+    CuckooHashTable ht(11);
+    const int capacity = ht.getCapacity();
+
+    // Ключи с одной и той же парой кандидатов: в таблицы влезают только два
+    auto target = ht.getCandidates(0);
+    std::vector<int> keys;
+    for (int k = 0; keys.size() < 2 + CuckooHashTable::kStashSize; ++k) {
+        if (ht.getCandidates(k) == target) keys.push_back(k);
+    }
+    for (int k : keys) BOOST_REQUIRE(ht.insert(k, "v" + std::to_string(k)));
+
+    BOOST_CHECK_EQUAL(ht.getStashSize(), CuckooHashTable::kStashSize);
+    BOOST_CHECK_EQUAL(ht.getCapacity(), capacity);
+    BOOST_CHECK_EQUAL(ht.getSize(), static_cast<int>(keys.size()));
+    for (int k : keys) BOOST_CHECK(ht.search(k) == "v" + std::to_string(k));
+    BOOST_CHECK(!ht.insert(keys.back(), "dup")); // дубликат в тайнике
+
+    std::vector<const std::string*> out(keys.size());
+    BOOST_CHECK_EQUAL(ht.searchBatch(keys.data(), keys.size(), out.data()), keys.size());
+
+    std::string output = captureOutput([&]() { ht.print(); });
+    BOOST_CHECK(output.find("Stash:") != std::string::npos);
+
+    // Сериализация сохраняет пары тайника
+    const std::string binfile = "cuckoo_stash.bin";
+    BOOST_CHECK(ht.serializeToBinary(binfile));
+    CuckooHashTable loaded;
+    BOOST_CHECK(loaded.deserializeFromBinary(binfile));
+    BOOST_CHECK_EQUAL(loaded.getSize(), ht.getSize());
+    BOOST_CHECK_EQUAL(loaded.getStashSize(), ht.getStashSize());
+    for (int k : keys) BOOST_CHECK(loaded.search(k) == "v" + std::to_string(k));
+    std::remove(binfile.c_str());
+
+    // Удаление из тайника
+    BOOST_CHECK(ht.remove(keys.back()));
+    BOOST_CHECK_EQUAL(ht.getStashSize(), CuckooHashTable::kStashSize - 1);
+    BOOST_CHECK(ht.search(keys.back()).empty());
+    for (size_t i = 0; i + 1 < keys.size(); ++i) BOOST_CHECK(!ht.search(keys[i]).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_stash_overflow_rebuilds) {
+    CuckooHashTable ht(11);
+    const int capacity = ht.getCapacity();
+    auto target = ht.getCandidates(0);
+    std::vector<int> keys;
+    for (int k = 0; keys.size() < 3 + CuckooHashTable::kStashSize; ++k) {
+        if (ht.getCandidates(k) == target) keys.push_back(k);
+    }
+    for (int k : keys) BOOST_REQUIRE(ht.insert(k, "x"));
+
+    // Переполнение тайника — перестройка с новыми зёрнами, ёмкость та же
+    BOOST_CHECK_EQUAL(ht.getCapacity(), capacity);
+    BOOST_CHECK(ht.getStashSize() < CuckooHashTable::kStashSize);
+    BOOST_CHECK_EQUAL(ht.getSize(), static_cast<int>(keys.size()));
+    for (int k : keys) BOOST_CHECK(ht.search(k) == "x");
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_cuckoo_basic) {
+    ConcurrentCuckooHashTable ht;
+    for (int i = 0; i < 20000; ++i) BOOST_REQUIRE(ht.insert(i * 11, std::to_string(i)));
+    BOOST_CHECK_EQUAL(ht.getSize(), 20000u);
+    BOOST_CHECK(ht.getCapacity() * 2 > 20000u);
+    BOOST_CHECK(!ht.insert(11, "dup"));
+    BOOST_CHECK(ht.search(11) == "1");
+
+    for (int i = 0; i < 20000; i += 2) BOOST_REQUIRE(ht.remove(i * 11));
+    BOOST_CHECK(!ht.remove(0));
+    BOOST_CHECK_EQUAL(ht.getSize(), 10000u);
+    for (int i = 0; i < 20000; ++i) BOOST_REQUIRE_EQUAL(ht.contains(i * 11), i % 2 == 1);
+
+    std::string value;
+    BOOST_CHECK(ht.tryGet(33, value));
+    BOOST_CHECK(value == "3");
+    BOOST_CHECK(!ht.tryGet(22, value));
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_cuckoo_readers_never_miss) {
+    ConcurrentCuckooHashTable ht;
+    const int STABLE = 2000;
+    for (int i = 0; i < STABLE; ++i) ht.insert(i, "s" + std::to_string(i));
+
+    // Постоянные ключи должны находиться всё время, пока писатели
+    // вытесняют их по путям и растят таблицу
+    std::atomic<bool> stop(false);
+    std::atomic<int> missed(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            while (!stop.load()) {
+                int key = static_cast<int>(gen() % STABLE);
+                if (ht.search(key) != "s" + std::to_string(key)) ++missed;
+            }
+        });
+    }
+
+    const int WRITERS = 2;
+    const int PER_WRITER = 30000;
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; ++w) {
+        writers.emplace_back([&, w] {
+            int base = STABLE + w * PER_WRITER;
+            for (int i = 0; i < PER_WRITER; ++i) ht.insert(base + i, "w");
+            for (int i = 0; i < PER_WRITER; i += 2) ht.remove(base + i);
+        });
+    }
+    for (auto& w : writers) w.join();
+    stop = true;
+    for (auto& r : readers) r.join();
+
+    BOOST_CHECK_EQUAL(missed.load(), 0);
+    BOOST_CHECK_EQUAL(ht.getSize(), static_cast<size_t>(STABLE + WRITERS * PER_WRITER / 2));
+    for (int k = STABLE; k < STABLE + WRITERS * PER_WRITER; ++k) {
+        BOOST_REQUIRE_EQUAL(ht.contains(k), (k - STABLE) % PER_WRITER % 2 == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_out_of_line_values) {
+    BOOST_CHECK_EQUAL(sizeof(CuckooNode), 8u); // вытеснение переносит 8 байт
+
+    CuckooHashTable ht;
+    std::string longValue(100, 'v');
+    BOOST_CHECK(ht.insert(1, std::move(longValue)));
+    BOOST_CHECK(ht.search(1) == std::string(100, 'v'));
+    BOOST_CHECK(!ht.insert(1, std::string(5, 'x')));
+    BOOST_CHECK(ht.insert(0, "")); // пустое значение — тоже ключ
+    BOOST_CHECK(!ht.insert(0, "again"));
+    BOOST_CHECK_EQUAL(ht.getSize(), 2);
+
+    // Освобождённые значения переиспользуются: память не растёт на вставке/удалении
+    for (int i = 2; i < 1000; ++i) ht.insert(i, "v" + std::to_string(i));
+    size_t before = 0;
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 2; i < 500; ++i) BOOST_REQUIRE(ht.remove(i));
+        for (int i = 2; i < 500; ++i) BOOST_REQUIRE(ht.insert(i, "r" + std::to_string(round)));
+        if (round == 0) before = ht.memoryUsage(); // список свободных уже выделен
+    }
+    BOOST_CHECK_EQUAL(ht.memoryUsage(), before);
+    BOOST_CHECK(ht.search(2) == "r4");
+    BOOST_CHECK(ht.search(999) == "v999");
+
+    const CuckooNode& node = ht.getTable1()[ht.getCandidates(999).first];
+    if (node.isOccupied() && node.getKey() == 999) BOOST_CHECK(ht.valueOf(node) == "v999");
+}
+
+template <typename Filter>
+double measureFalsePositives(const Filter& filter, int from, int count) {
+    int positives = 0;
+    for (int k = from; k < from + count; ++k) positives += filter.contains(k);
+    return static_cast<double>(positives) / count;
+}
+
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_membership) {
+    const int COUNT = 100000;
+    for (double rate : {0.01, 0.001}) {
+        CuckooFilter filter(COUNT, rate);
+        for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(filter.insert(i * 3));
+        BOOST_CHECK_EQUAL(filter.getSize(), static_cast<size_t>(COUNT));
+        for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(filter.contains(i * 3)); // ложных «нет» не бывает
+
+        double fpr = measureFalsePositives(filter, 10000000, 200000);
+        BOOST_CHECK_MESSAGE(fpr < 2 * rate, "false positive rate " << fpr << " for target " << rate);
+        BOOST_CHECK(filter.memoryUsage() <= 3 * static_cast<size_t>(COUNT));
+    }
+
+    CuckooFilter8 small(COUNT, 0.05);
+    BOOST_CHECK_EQUAL(small.getFingerprintBits(), 8u);
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(small.insert(i));
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(small.contains(i));
+    BOOST_CHECK(measureFalsePositives(small, 10000000, 200000) < 0.1);
+    BOOST_CHECK(small.memoryUsage() <= 2 * static_cast<size_t>(COUNT));
+}
+
+// Заданная вероятность недостижима в 8 битах: ширина ограничена типом,
+// а achievedFpr() сообщает, что получилось на самом деле
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_achieved_fpr) {
+    const int COUNT = 100000;
+    CuckooFilter wide(COUNT, 0.01);
+    BOOST_CHECK_EQUAL(wide.getFingerprintBits(), 10u);
+    BOOST_CHECK(wide.achievedFpr() <= 0.01);
+
+    CuckooFilter8 narrow(COUNT, 0.01);
+    BOOST_CHECK_EQUAL(narrow.getFingerprintBits(), 8u);
+    BOOST_CHECK(narrow.achievedFpr() > 0.01);
+    BOOST_CHECK_CLOSE(narrow.achievedFpr(), 8.0 / 255, 1e-9);
+
+    for (int i = 0; i < COUNT; ++i) BOOST_REQUIRE(narrow.insert(i * 3));
+    double fpr = measureFalsePositives(narrow, 10000000, 200000);
+    BOOST_CHECK_MESSAGE(fpr > 0.01, "false positive rate " << fpr << " below the unreachable target");
+    BOOST_CHECK_MESSAGE(fpr <= narrow.achievedFpr(), "false positive rate " << fpr << " above " << narrow.achievedFpr());
+}
+
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_remove) {
+    CuckooFilter filter(10000, 0.001);
+    for (int i = 0; i < 10000; ++i) filter.insert(i);
+    for (int i = 0; i < 10000; i += 2) BOOST_REQUIRE(filter.remove(i));
+    BOOST_CHECK_EQUAL(filter.getSize(), 5000u);
+    for (int i = 1; i < 10000; i += 2) BOOST_REQUIRE(filter.contains(i));
+    int stale = 0;
+    for (int i = 0; i < 10000; i += 2) stale += filter.contains(i);
+    BOOST_CHECK(stale < 50);
+
+    // Две вставки — две копии отпечатка
+    BOOST_CHECK(filter.insert(-5));
+    BOOST_CHECK(filter.insert(-5));
+    BOOST_CHECK(filter.remove(-5));
+    BOOST_CHECK(filter.contains(-5));
+    BOOST_CHECK(filter.remove(-5));
+
+    filter.clear();
+    BOOST_CHECK(filter.isEmpty());
+    BOOST_CHECK(!filter.contains(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_full) {
+    CuckooFilter filter(1000, 0.01);
+    std::vector<int> inserted;
+    for (int k = 0; k < 100000; ++k) {
+        if (!filter.insert(k)) break;
+        inserted.push_back(k);
+    }
+    // Заполняется выше расчётной загрузки, но не бесконечно; вставленное не теряется
+    BOOST_CHECK(inserted.size() >= 1000u);
+    BOOST_CHECK(inserted.size() < 100000u);
+    BOOST_CHECK(filter.loadFactor() > 0.9f);
+    for (int k : inserted) BOOST_REQUIRE(filter.contains(k));
+
+    // Удаление освобождает место
+    BOOST_CHECK(filter.remove(inserted[0]));
+    BOOST_CHECK(filter.remove(inserted[1]));
+    BOOST_CHECK(filter.insert(-1));
+    for (size_t i = 2; i < inserted.size(); ++i) BOOST_REQUIRE(filter.contains(inserted[i]));
+}
+
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_serialization) {
+    CuckooFilter filter(5000, 0.001);
+    for (int i = 0; i < 5000; ++i) filter.insert(i * 7);
+
+    const std::string file = "cuckoo_filter.bin";
+    BOOST_REQUIRE(filter.serializeToBinary(file));
+    CuckooFilter loaded(16);
+    BOOST_REQUIRE(loaded.deserializeFromBinary(file));
+    BOOST_CHECK_EQUAL(loaded.getSize(), filter.getSize());
+    BOOST_CHECK_EQUAL(loaded.getCapacity(), filter.getCapacity());
+    BOOST_CHECK_EQUAL(loaded.getFingerprintBits(), filter.getFingerprintBits());
+    for (int k = -1000; k < 40000; ++k) BOOST_REQUIRE_EQUAL(loaded.contains(k), filter.contains(k));
+
+    // Другой тип отпечатка — отказ, фильтр не меняется
+    CuckooFilter8 other(16);
+    BOOST_CHECK(!other.deserializeFromBinary(file));
+    BOOST_CHECK(other.isEmpty());
+    BOOST_CHECK(!loaded.deserializeFromBinary("no_such_filter.bin"));
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_cuckoo_filter_rejects_damage) {
+    CuckooFilter filter(2000, 0.001);
+    for (int i = 0; i < 2000; ++i) filter.insert(i);
+    const std::string file = "cuckoo_filter_damaged.bin";
+    BOOST_REQUIRE(filter.serializeToBinary(file));
+
+    std::string bytes;
+    {
+        std::ifstream in(file, std::ios::binary);
+        bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    auto writeBytes = [&](const std::string& data) {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    };
+    // Поля заголовка: magic[8], fingerprintSize и fingerprintBits (uint32),
+    // bucketCount и size (uint64), victimBucket (uint64), hasVictim и victim (uint32)
+    auto patch64 = [&](size_t offset, uint64_t value) {
+        std::string damaged = bytes;
+        std::memcpy(&damaged[offset], &value, sizeof(value));
+        return damaged;
+    };
+    auto patch32 = [&](size_t offset, uint32_t value) {
+        std::string damaged = bytes;
+        std::memcpy(&damaged[offset], &value, sizeof(value));
+        return damaged;
+    };
+
+    CuckooFilter target(16);
+    target.insert(-7);
+    auto unchanged = [&]() { return target.getSize() == 1 && target.contains(-7) && target.getBucketCount() == 8; };
+
+    // Жертва шире отпечатков фильтра
+    std::string wideVictim = patch32(40, 1);
+    const uint32_t victim = uint32_t(1) << filter.getFingerprintBits();
+    std::memcpy(&wideVictim[44], &victim, sizeof(victim));
+
+    std::string flipped = bytes;
+    flipped[bytes.size() - 3] ^= 0x01;
+    for (const std::string& damaged :
+         {flipped, bytes.substr(0, bytes.size() - 1), bytes + "x", bytes.substr(0, 40),
+          patch64(16, uint64_t(1) << 62), patch64(16, uint64_t(1) << 30), patch64(24, uint64_t(1) << 40),
+          patch64(24, filter.getSize() + 1), patch32(12, 2), wideVictim}) {
+        writeBytes(damaged);
+        BOOST_CHECK(!target.deserializeFromBinary(file));
+        BOOST_CHECK(unchanged());
+    }
+
+    writeBytes(bytes);
+    BOOST_CHECK(target.deserializeFromBinary(file));
+    BOOST_CHECK_EQUAL(target.getSize(), filter.getSize());
+    std::remove(file.c_str());
+}
+
+// Снимок восстанавливает каждую пару в тот же слот той же таблицы
+template <typename Table>
+void checkSameLayout(const Table& a, const Table& b) {
+    BOOST_REQUIRE_EQUAL(a.getCapacity(), b.getCapacity());
+    BOOST_REQUIRE_EQUAL(a.getSize(), b.getSize());
+    BOOST_REQUIRE_EQUAL(a.getStashSize(), b.getStashSize());
+    auto same = [&](const CuckooNode& x, const CuckooNode& y) {
+        BOOST_REQUIRE_EQUAL(x.isOccupied(), y.isOccupied());
+        if (!x.isOccupied()) return;
+        BOOST_REQUIRE_EQUAL(x.getKey(), y.getKey());
+        BOOST_REQUIRE(a.valueOf(x) == b.valueOf(y));
+    };
+    for (int i = 0; i < a.getCapacity(); ++i) {
+        same(a.getTable1()[i], b.getTable1()[i]);
+        same(a.getTable2()[i], b.getTable2()[i]);
+    }
+    for (int i = 0; i < a.getStashSize(); ++i) same(a.getStash()[i], b.getStash()[i]);
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_layout) {
+    BasicCuckooHashTable<Pow2MixPolicy> ht;
+    std::mt19937 gen(23);
+    std::vector<int> keys;
+    for (int i = 0; i < 20000; ++i) {
+        int k = static_cast<int>(gen());
+        if (ht.insert(k, std::string(k & 31, 'x') + std::to_string(k))) keys.push_back(k);
+    }
+    // Дыры в пуле значений: в файле дескрипторы идут подряд
+    for (size_t i = 0; i < keys.size(); i += 3) ht.remove(keys[i]);
+
+    const std::string binfile = "cuckoo_layout.bin";
+    BOOST_REQUIRE(ht.serializeToBinary(binfile));
+    BasicCuckooHashTable<Pow2MixPolicy> loaded(7);
+    BOOST_REQUIRE(loaded.deserializeFromBinary(binfile));
+    checkSameLayout(ht, loaded);
+    BOOST_CHECK(loaded.getCandidates(12345) == ht.getCandidates(12345)); // те же зёрна
+
+    // После загрузки таблицы ведут себя одинаково
+    for (int i = 0; i < 5000; ++i) {
+        int k = static_cast<int>(gen());
+        BOOST_REQUIRE_EQUAL(ht.insert(k, "n"), loaded.insert(k, "n"));
+    }
+    checkSameLayout(ht, loaded);
+
+    // Снимок снимка совпадает с исходным файлом побайтно
+    const std::string again = "cuckoo_layout2.bin";
+    BOOST_REQUIRE(ht.serializeToBinary(binfile));
+    BOOST_REQUIRE(loaded.serializeToBinary(again));
+    std::ifstream f1(binfile, std::ios::binary), f2(again, std::ios::binary);
+    std::string bytes1((std::istreambuf_iterator<char>(f1)), std::istreambuf_iterator<char>());
+    std::string bytes2((std::istreambuf_iterator<char>(f2)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(bytes1 == bytes2);
+
+    std::remove(binfile.c_str());
+    std::remove(again.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_rejects_damage) {
+    CuckooHashTable ht;
+    for (int i = 0; i < 500; ++i) ht.insert(i, "value" + std::to_string(i));
+    const std::string binfile = "cuckoo_damaged.bin";
+    BOOST_REQUIRE(ht.serializeToBinary(binfile));
+
+    std::string bytes;
+    {
+        std::ifstream in(binfile, std::ios::binary);
+        bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    auto writeBytes = [&](const std::string& data) {
+        std::ofstream out(binfile, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+    };
+
+    CuckooHashTable target;
+    target.insert(-1, "keep");
+    auto unchanged = [&]() { return target.getSize() == 1 && target.search(-1) == "keep"; };
+
+    // Испорченный байт в слотах и в значениях
+    for (size_t pos : {bytes.size() / 3, bytes.size() - 2}) {
+        std::string damaged = bytes;
+        damaged[pos] ^= 0x10;
+        writeBytes(damaged);
+        BOOST_CHECK(!target.deserializeFromBinary(binfile));
+        BOOST_CHECK(unchanged());
+    }
+    // Обрезанный файл и лишний хвост
+    writeBytes(bytes.substr(0, bytes.size() - 1));
+    BOOST_CHECK(!target.deserializeFromBinary(binfile));
+    writeBytes(bytes + "x");
+    BOOST_CHECK(!target.deserializeFromBinary(binfile));
+    BOOST_CHECK(unchanged());
+
+    // Заголовок с огромными capacity и size при коротком файле отклоняется
+    // по длине, до выделения памяти под слоты
+    {
+        std::string huge = bytes;
+        const uint32_t capacity = static_cast<uint32_t>(PrimeModPolicy::roundCapacity(uint32_t(1) << 29));
+        std::memcpy(&huge[12], &capacity, sizeof(capacity)); // magic[8], policyId, capacity, size
+        std::memcpy(&huge[16], &capacity, sizeof(capacity));
+        writeBytes(huge);
+        BOOST_CHECK(!target.deserializeFromBinary(binfile));
+        BOOST_CHECK(unchanged());
+    }
+
+    // Снимок другой Policy
+    writeBytes(bytes);
+    BasicCuckooHashTable<Pow2MixPolicy> other;
+    BOOST_CHECK(!other.deserializeFromBinary(binfile));
+    BOOST_CHECK(target.deserializeFromBinary(binfile));
+    checkSameLayout(ht, target);
+
+    std::remove(binfile.c_str());
+}
 #endif
\ No newline at end of file
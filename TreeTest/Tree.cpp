@@ -460,3 +460,393 @@ bool AVLTree::validate() const {
     int height;
     return validateHelper(root.get(), height);
 }
+
+// ArenaAVLTree implementation
+ArenaAVLTree::ArenaAVLTree() : nodes(1, ArenaAVLNode{0, kNil, kNil, 0}), root(kNil), freeHead(kNil), count(0) {}
+
+uint32_t ArenaAVLTree::allocNode(int key) {
+    uint32_t node = freeHead;
+    if (node != kNil) {
+        freeHead = nodes[node].left;
+    } else {
+        if (nodes.size() > UINT32_MAX - 1) {
+            throw std::length_error("ArenaAVLTree: too many nodes");
+        }
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[node] = ArenaAVLNode{key, kNil, kNil, 1};
+    return node;
+}
+
+void ArenaAVLTree::freeNode(uint32_t node) {
+    nodes[node].left = freeHead;
+    freeHead = node;
+}
+
+int ArenaAVLTree::getBalance(uint32_t node) const {
+    return getHeight(nodes[node].left) - getHeight(nodes[node].right);
+}
+
+void ArenaAVLTree::updateHeight(uint32_t node) {
+    nodes[node].height = static_cast<uint8_t>(1 + std::max(getHeight(nodes[node].left), getHeight(nodes[node].right)));
+}
+
+uint32_t ArenaAVLTree::rightRotate(uint32_t y) {
+    uint32_t x = nodes[y].left;
+    nodes[y].left = nodes[x].right;
+    nodes[x].right = y;
+    updateHeight(y);
+    updateHeight(x);
+    return x;
+}
+
+uint32_t ArenaAVLTree::leftRotate(uint32_t x) {
+    uint32_t y = nodes[x].right;
+    nodes[x].right = nodes[y].left;
+    nodes[y].left = x;
+    updateHeight(x);
+    updateHeight(y);
+    return y;
+}
+
+//       
+uint32_t ArenaAVLTree::rebalance(uint32_t node) {
+    updateHeight(node);
+    int balance = getBalance(node);
+    if (balance > 1) {
+        if (getBalance(nodes[node].left) < 0) {
+            nodes[node].left = leftRotate(nodes[node].left);
+        }
+        return rightRotate(node);
+    }
+    if (balance < -1) {
+        if (getBalance(nodes[node].right) > 0) {
+            nodes[node].right = rightRotate(nodes[node].right);
+        }
+        return leftRotate(node);
+    }
+    return node;
+}
+
+uint32_t ArenaAVLTree::insert(uint32_t node, int key) {
+    if (node == kNil) {
+        ++count;
+        return allocNode(key);
+    }
+
+    // allocNode         
+    if (key < nodes[node].key) {
+        uint32_t child = insert(nodes[node].left, key);
+        nodes[node].left = child;
+    } else if (key > nodes[node].key) {
+        uint32_t child = insert(nodes[node].right, key);
+        nodes[node].right = child;
+    } else {
+        //   
+        return node;
+    }
+    return rebalance(node);
+}
+
+uint32_t ArenaAVLTree::deleteNode(uint32_t node, int key) {
+    if (node == kNil) return kNil;
+
+    if (key < nodes[node].key) {
+        nodes[node].left = deleteNode(nodes[node].left, key);
+    } else if (key > nodes[node].key) {
+        nodes[node].right = deleteNode(nodes[node].right, key);
+    } else if (nodes[node].left == kNil || nodes[node].right == kNil) {
+        //    
+        uint32_t child = nodes[node].left != kNil ? nodes[node].left : nodes[node].right;
+        freeNode(node);
+        --count;
+        return child;
+    } else {
+        //  :     
+        uint32_t successor = nodes[node].right;
+        while (nodes[successor].left != kNil) {
+            successor = nodes[successor].left;
+        }
+        nodes[node].key = nodes[successor].key;
+        nodes[node].right = deleteNode(nodes[node].right, nodes[successor].key);
+    }
+    return rebalance(node);
+}
+
+void ArenaAVLTree::inorder(uint32_t node, std::vector<int>& result) const {
+    if (node != kNil) {
+        inorder(nodes[node].left, result);
+        result.push_back(nodes[node].key);
+        inorder(nodes[node].right, result);
+    }
+}
+
+void ArenaAVLTree::preorder(uint32_t node, std::vector<int>& result) const {
+    if (node != kNil) {
+        result.push_back(nodes[node].key);
+        preorder(nodes[node].left, result);
+        preorder(nodes[node].right, result);
+    }
+}
+
+void ArenaAVLTree::postorder(uint32_t node, std::vector<int>& result) const {
+    if (node != kNil) {
+        postorder(nodes[node].left, result);
+        postorder(nodes[node].right, result);
+        result.push_back(nodes[node].key);
+    }
+}
+
+void ArenaAVLTree::insert(int key) {
+    root = insert(root, key);
+}
+
+void ArenaAVLTree::remove(int key) {
+    root = deleteNode(root, key);
+}
+
+bool ArenaAVLTree::search(int key) const {
+    uint32_t node = root;
+    while (node != kNil) {
+        const ArenaAVLNode& n = nodes[node];
+        if (n.key == key) return true;
+        node = key < n.key ? n.left : n.right;
+    }
+    return false;
+}
+
+std::vector<int> ArenaAVLTree::inorder() const {
+    std::vector<int> result;
+    result.reserve(count);
+    inorder(root, result);
+    return result;
+}
+
+std::vector<int> ArenaAVLTree::preorder() const {
+    std::vector<int> result;
+    result.reserve(count);
+    preorder(root, result);
+    return result;
+}
+
+std::vector<int> ArenaAVLTree::postorder() const {
+    std::vector<int> result;
+    result.reserve(count);
+    postorder(root, result);
+    return result;
+}
+
+void ArenaAVLTree::printInorder() const {
+    std::cout << "Inorder: ";
+    for (int key : inorder()) {
+        std::cout << key << " ";
+    }
+    std::cout << std::endl;
+}
+
+void ArenaAVLTree::printPreorder() const {
+    std::cout << "Preorder: ";
+    for (int key : preorder()) {
+        std::cout << key << " ";
+    }
+    std::cout << std::endl;
+}
+
+void ArenaAVLTree::printPostorder() const {
+    std::cout << "Postorder: ";
+    for (int key : postorder()) {
+        std::cout << key << " ";
+    }
+    std::cout << std::endl;
+}
+
+bool ArenaAVLTree::isBalanced() const {
+    int height;
+    size_t visited = 0;
+    return validateHelper(root, height, visited);
+}
+
+int ArenaAVLTree::minValue() const {
+    if (root == kNil) throw std::runtime_error("Tree is empty");
+
+    uint32_t current = root;
+    while (nodes[current].left != kNil) {
+        current = nodes[current].left;
+    }
+    return nodes[current].key;
+}
+
+int ArenaAVLTree::maxValue() const {
+    if (root == kNil) throw std::runtime_error("Tree is empty");
+
+    uint32_t current = root;
+    while (nodes[current].right != kNil) {
+        current = nodes[current].right;
+    }
+    return nodes[current].key;
+}
+
+void ArenaAVLTree::clear() {
+    //  : resize   ,  
+    nodes.resize(1);
+    root = kNil;
+    freeHead = kNil;
+    count = 0;
+}
+
+//  
+void ArenaAVLTree::exportToTextFile(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    auto keys = preorder();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        out << keys[i];
+        if (i != keys.size() - 1) out << " ";
+    }
+}
+
+ArenaAVLTree ArenaAVLTree::importFromTextFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    ArenaAVLTree tree;
+    int key;
+    while (in >> key) {
+        tree.insert(key);
+    }
+
+    return tree;
+}
+
+//  :   ,   AVLNode::serializeBinary
+void ArenaAVLTree::serializeBinary(uint32_t node, std::ofstream& out) const {
+    const ArenaAVLNode& n = nodes[node];
+    int height = n.height;
+    bool hasLeft = n.left != kNil;
+    bool hasRight = n.right != kNil;
+    out.write(reinterpret_cast<const char*>(&n.key), sizeof(n.key));
+    out.write(reinterpret_cast<const char*>(&height), sizeof(height));
+    out.write(reinterpret_cast<const char*>(&hasLeft), sizeof(hasLeft));
+    out.write(reinterpret_cast<const char*>(&hasRight), sizeof(hasRight));
+
+    if (hasLeft) {
+        serializeBinary(n.left, out);
+    }
+    if (hasRight) {
+        serializeBinary(n.right, out);
+    }
+}
+
+uint32_t ArenaAVLTree::deserializeBinary(std::ifstream& in) {
+    int nodeKey, nodeHeight;
+    bool hasLeft, hasRight;
+
+    in.read(reinterpret_cast<char*>(&nodeKey), sizeof(nodeKey));
+    in.read(reinterpret_cast<char*>(&nodeHeight), sizeof(nodeHeight));
+    in.read(reinterpret_cast<char*>(&hasLeft), sizeof(hasLeft));
+    in.read(reinterpret_cast<char*>(&hasRight), sizeof(hasRight));
+
+    if (!in) {
+        throw std::runtime_error("Error reading binary data");
+    }
+    if (nodeHeight < 1 || nodeHeight > UINT8_MAX) {
+        throw std::runtime_error("Binary file corrupted: bad node height");
+    }
+
+    uint32_t node = allocNode(nodeKey);
+    ++count;
+    nodes[node].height = static_cast<uint8_t>(nodeHeight);
+
+    if (hasLeft) {
+        uint32_t child = deserializeBinary(in);
+        nodes[node].left = child;
+    }
+    if (hasRight) {
+        uint32_t child = deserializeBinary(in);
+        nodes[node].right = child;
+    }
+
+    return node;
+}
+
+void ArenaAVLTree::exportToBinaryFile(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open binary file: " + path);
+    }
+
+    size_t nodeCount = count;
+    out.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+
+    if (root != kNil) {
+        serializeBinary(root, out);
+    }
+}
+
+ArenaAVLTree ArenaAVLTree::importFromBinaryFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open binary file: " + path);
+    }
+
+    ArenaAVLTree tree;
+
+    size_t expectedNodeCount;
+    in.read(reinterpret_cast<char*>(&expectedNodeCount), sizeof(expectedNodeCount));
+
+    if (!in) {
+        throw std::runtime_error("Error reading binary file header");
+    }
+
+    if (expectedNodeCount > 0) {
+        tree.root = tree.deserializeBinary(in);
+
+        if (tree.size() != expectedNodeCount) {
+            throw std::runtime_error("Binary file corrupted: node count mismatch");
+        }
+    }
+
+    return tree;
+}
+
+//  
+bool ArenaAVLTree::validateHelper(uint32_t node, int& height, size_t& visited) const {
+    if (node == kNil) {
+        height = 0;
+        return true;
+    }
+    if (++visited > count) {
+        return false;
+    }
+
+    const ArenaAVLNode& n = nodes[node];
+    int leftHeight, rightHeight;
+    bool leftValid = validateHelper(n.left, leftHeight, visited);
+    bool rightValid = validateHelper(n.right, rightHeight, visited);
+
+    height = 1 + std::max(leftHeight, rightHeight);
+
+    if (std::abs(leftHeight - rightHeight) > 1) {
+        return false;
+    }
+    if (n.left != kNil && nodes[n.left].key >= n.key) {
+        return false;
+    }
+    if (n.right != kNil && nodes[n.right].key <= n.key) {
+        return false;
+    }
+
+    return leftValid && rightValid && n.height == height;
+}
+
+bool ArenaAVLTree::validate() const {
+    int height;
+    size_t visited = 0;
+    return validateHelper(root, height, visited) && visited == count;
+}
@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <cstring>
+#include <cstdint>
 
 //  AVL 
 class AVLNode {
@@ -120,3 +121,97 @@ public:
 private:
     bool validateHelper(const AVLNode* node, int& height) const;
 };
+
+//    :    , 0   
+struct ArenaAVLNode {
+    int key;
+    uint32_t left;
+    uint32_t right;
+    uint8_t height;
+};
+
+// AVL        (16   ).
+//       (  left) 
+// ; clear()    O(1),   .
+//        AVLTree.
+class ArenaAVLTree {
+private:
+    // nodes[0]     0,     
+    std::vector<ArenaAVLNode> nodes;
+    uint32_t root;
+    uint32_t freeHead;
+    size_t count;
+
+    static constexpr uint32_t kNil = 0;
+
+    //         
+    uint32_t allocNode(int key);
+
+    //     
+    void freeNode(uint32_t node);
+
+    int getHeight(uint32_t node) const { return nodes[node].height; }
+    int getBalance(uint32_t node) const;
+    void updateHeight(uint32_t node);
+
+    uint32_t rightRotate(uint32_t y);
+    uint32_t leftRotate(uint32_t x);
+    uint32_t rebalance(uint32_t node);
+
+    uint32_t insert(uint32_t node, int key);
+    uint32_t deleteNode(uint32_t node, int key);
+
+    void inorder(uint32_t node, std::vector<int>& result) const;
+    void preorder(uint32_t node, std::vector<int>& result) const;
+    void postorder(uint32_t node, std::vector<int>& result) const;
+
+    void serializeBinary(uint32_t node, std::ofstream& out) const;
+    uint32_t deserializeBinary(std::ifstream& in);
+
+    bool validateHelper(uint32_t node, int& height, size_t& visited) const;
+
+public:
+    ArenaAVLTree();
+
+    //  
+    void insert(int key);
+    void remove(int key);
+    bool search(int key) const;
+    bool contains(int key) const { return search(key); }
+
+    // 
+    std::vector<int> inorder() const;
+    std::vector<int> preorder() const;
+    std::vector<int> postorder() const;
+
+    // 
+    void printInorder() const;
+    void printPreorder() const;
+    void printPostorder() const;
+
+    //   
+    int getHeight() const { return getHeight(root); }
+    bool isBalanced() const;
+    bool isEmpty() const { return root == kNil; }
+    size_t size() const { return count; }
+    int minValue() const;
+    int maxValue() const;
+
+    //   O(1):   
+    void clear();
+    //    n 
+    void reserve(size_t n) { nodes.reserve(n + 1); }
+    //    (   )
+    size_t memoryUsage() const { return nodes.capacity() * sizeof(ArenaAVLNode); }
+
+    //  
+    void exportToTextFile(const std::string& path) const;
+    static ArenaAVLTree importFromTextFile(const std::string& path);
+
+    //  
+    void exportToBinaryFile(const std::string& path) const;
+    static ArenaAVLTree importFromBinaryFile(const std::string& path);
+
+    //   (  AVL)
+    bool validate() const;
+};
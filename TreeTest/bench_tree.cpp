@@ -2,6 +2,7 @@
 #define BOOST_TEST_MODULE AVLTreeBenchmark
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
+#include <boost/mpl/list.hpp>
 #include "Tree.h"
 #include <random>
 #include <fstream>
@@ -9,6 +10,15 @@
 #include <chrono>
 #include <set>
 #include <algorithm>
+#include <type_traits>
+
+// Деревья с узлами в куче и в арене: каждый замер идёт для обоих
+typedef boost::mpl::list<AVLTree, ArenaAVLTree> TreeTypes;
+
+template <typename Tree>
+const char* treeName() {
+    return std::is_same<Tree, AVLTree>::value ? "AVLTree" : "ArenaAVLTree";
+}
 
 // Генерация случайных уникальных ключей
 std::vector<int> generateUniqueKeys(size_t count, int minVal = 1, int maxVal = 1000000) {
@@ -23,7 +33,7 @@ std::vector<int> generateUniqueKeys(size_t count, int minVal = 1, int maxVal = 1
     return std::vector<int>(uniqueKeys.begin(), uniqueKeys.end());
 }
 
-BOOST_AUTO_TEST_CASE(BenchmarkInsertRandom) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(BenchmarkInsertRandom, Tree, TreeTypes) {
     const size_t SIZES[] = {100, 1000, 10000, 50000};
 
     for (size_t size : SIZES) {
@@ -31,7 +41,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkInsertRandom) {
 
         auto start = std::chrono::high_resolution_clock::now();
 
-        AVLTree tree;
+        Tree tree;
         for (int key : keys) {
             tree.insert(key);
         }
@@ -39,19 +49,27 @@ BOOST_AUTO_TEST_CASE(BenchmarkInsertRandom) {
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-        BOOST_TEST_MESSAGE("Insert " << size << " random elements: "
+        BOOST_TEST_MESSAGE(treeName<Tree>() << ": insert " << size << " random elements: "
                           << duration.count() << " ms");
         BOOST_CHECK_EQUAL(tree.size(), size);
         BOOST_CHECK(tree.isBalanced());
         BOOST_CHECK(tree.validate());
+
+        // Очистка: обход с delete против сброса арены
+        start = std::chrono::high_resolution_clock::now();
+        tree.clear();
+        end = std::chrono::high_resolution_clock::now();
+        BOOST_TEST_MESSAGE(treeName<Tree>() << ": clear " << size << " elements: "
+                          << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " µs");
+        BOOST_CHECK(tree.isEmpty());
     }
 }
 
-BOOST_AUTO_TEST_CASE(BenchmarkSearch) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(BenchmarkSearch, Tree, TreeTypes) {
     const size_t SIZE = 10000;
     auto keys = generateUniqueKeys(SIZE);
 
-    AVLTree tree;
+    Tree tree;
     for (int key : keys) {
         tree.insert(key);
     }
@@ -70,7 +88,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkSearch) {
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    BOOST_TEST_MESSAGE("Search 1000 existing elements: "
+    BOOST_TEST_MESSAGE(treeName<Tree>() << ": search 1000 existing elements: "
                       << duration.count() << " µs ("
                       << duration.count() / 1000.0 << " µs per search)");
     BOOST_CHECK_EQUAL(foundCount, 1000);
@@ -88,7 +106,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkSearch) {
     end = std::chrono::high_resolution_clock::now();
     duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    BOOST_TEST_MESSAGE("Search 1000 non-existing elements: "
+    BOOST_TEST_MESSAGE(treeName<Tree>() << ": search 1000 non-existing elements: "
                       << duration.count() << " µs ("
                       << duration.count() / 1000.0 << " µs per search)");
     BOOST_CHECK_EQUAL(notFoundCount, 1000);
@@ -122,11 +140,11 @@ BOOST_AUTO_TEST_CASE(BenchmarkRemove) {
     BOOST_CHECK(tree.validate());
 }
 
-BOOST_AUTO_TEST_CASE(BenchmarkTraversals) {
+BOOST_AUTO_TEST_CASE_TEMPLATE(BenchmarkTraversals, Tree, TreeTypes) {
     const size_t SIZE = 50000;
     auto keys = generateUniqueKeys(SIZE);
 
-    AVLTree tree;
+    Tree tree;
     for (int key : keys) {
         tree.insert(key);
     }
@@ -137,7 +155,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkTraversals) {
     auto end = std::chrono::high_resolution_clock::now();
     auto inorderTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    BOOST_TEST_MESSAGE("Inorder traversal of " << SIZE << " elements: "
+    BOOST_TEST_MESSAGE(treeName<Tree>() << ": inorder traversal of " << SIZE << " elements: "
                       << inorderTime.count() << " µs");
     BOOST_CHECK(std::is_sorted(inorderResult.begin(), inorderResult.end()));
 
@@ -147,7 +165,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkTraversals) {
     end = std::chrono::high_resolution_clock::now();
     auto preorderTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    BOOST_TEST_MESSAGE("Preorder traversal of " << SIZE << " elements: "
+    BOOST_TEST_MESSAGE(treeName<Tree>() << ": preorder traversal of " << SIZE << " elements: "
                       << preorderTime.count() << " µs");
     BOOST_CHECK_EQUAL(preorderResult.size(), SIZE);
 
@@ -157,7 +175,7 @@ BOOST_AUTO_TEST_CASE(BenchmarkTraversals) {
     end = std::chrono::high_resolution_clock::now();
     auto postorderTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
 
-    BOOST_TEST_MESSAGE("Postorder traversal of " << SIZE << " elements: "
+    BOOST_TEST_MESSAGE(treeName<Tree>() << ": postorder traversal of " << SIZE << " elements: "
                       << postorderTime.count() << " µs");
     BOOST_CHECK_EQUAL(postorderResult.size(), SIZE);
 }
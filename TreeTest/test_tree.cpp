@@ -335,4 +335,111 @@ BOOST_AUTO_TEST_CASE(StressTest) {
 
     BOOST_CHECK(tree.validate());
 }
+
+BOOST_AUTO_TEST_CASE(ArenaMatchesAVLTree) {
+    AVLTree reference;
+    ArenaAVLTree tree;
+    BOOST_CHECK(tree.isEmpty());
+    BOOST_CHECK_EQUAL(tree.getHeight(), 0);
+
+    std::mt19937 rng(25);
+    std::uniform_int_distribution<int> dist(1, 5000);
+    for (int i = 0; i < 20000; ++i) {
+        int key = dist(rng);
+        if (i % 3 == 2) {
+            reference.remove(key);
+            tree.remove(key);
+        } else {
+            reference.insert(key);
+            tree.insert(key);
+        }
+    }
+
+    // Те же повороты — та же форма дерева
+    BOOST_CHECK_EQUAL(tree.size(), reference.size());
+    BOOST_CHECK_EQUAL(tree.getHeight(), reference.getHeight());
+    auto expected = reference.preorder();
+    auto actual = tree.preorder();
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+    BOOST_CHECK(tree.validate());
+    BOOST_CHECK_EQUAL(tree.minValue(), reference.minValue());
+    BOOST_CHECK_EQUAL(tree.maxValue(), reference.maxValue());
+    for (int key = 0; key <= 5001; ++key) {
+        BOOST_REQUIRE_EQUAL(tree.search(key), reference.search(key));
+    }
+
+    ArenaAVLTree copy(tree);
+    tree.clear();
+    BOOST_CHECK(tree.isEmpty());
+    BOOST_CHECK_THROW(tree.minValue(), std::runtime_error);
+    BOOST_CHECK_EQUAL(copy.size(), reference.size());
+    BOOST_CHECK(copy.validate());
+}
+
+BOOST_AUTO_TEST_CASE(ArenaReusesFreedNodes) {
+    ArenaAVLTree tree;
+    for (int i = 0; i < 10000; ++i) {
+        tree.insert(i);
+    }
+    const size_t memory = tree.memoryUsage();
+
+    // Удалённые узлы идут в список свободных, арена не растёт
+    for (int i = 0; i < 10000; i += 2) {
+        tree.remove(i);
+    }
+    for (int i = 10000; i < 15000; ++i) {
+        tree.insert(i);
+    }
+    BOOST_CHECK_EQUAL(tree.memoryUsage(), memory);
+    BOOST_CHECK_EQUAL(tree.size(), 10000);
+    BOOST_CHECK(tree.validate());
+
+    // clear() сохраняет ёмкость
+    tree.clear();
+    BOOST_CHECK_EQUAL(tree.memoryUsage(), memory);
+    for (int i = 0; i < 10000; ++i) {
+        tree.insert(-i);
+    }
+    BOOST_CHECK_EQUAL(tree.memoryUsage(), memory);
+    BOOST_CHECK(tree.validate());
+}
+
+BOOST_AUTO_TEST_CASE(ArenaSerializationCompatible) {
+    const std::string filename = "arena_tree.bin";
+    const std::string textFile = "arena_tree.txt";
+
+    AVLTree tree;
+    for (int i = 0; i < 300; ++i) {
+        tree.insert(i * 7 % 1000);
+    }
+
+    // Файлы AVLTree читаются ArenaAVLTree и наоборот
+    tree.exportToBinaryFile(filename);
+    ArenaAVLTree arena = ArenaAVLTree::importFromBinaryFile(filename);
+    BOOST_CHECK_EQUAL(arena.size(), tree.size());
+    BOOST_CHECK(arena.validate());
+    auto expected = tree.preorder();
+    auto actual = arena.preorder();
+    BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+
+    arena.remove(0);
+    arena.exportToBinaryFile(filename);
+    AVLTree back = AVLTree::importFromBinaryFile(filename);
+    BOOST_CHECK(back.validate());
+    BOOST_CHECK_EQUAL(back.size(), tree.size() - 1);
+
+    arena.exportToTextFile(textFile);
+    ArenaAVLTree fromText = ArenaAVLTree::importFromTextFile(textFile);
+    actual = arena.inorder();
+    auto reloaded = fromText.inorder();
+    BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), reloaded.begin(), reloaded.end());
+
+    ArenaAVLTree empty;
+    empty.exportToBinaryFile(filename);
+    BOOST_CHECK(ArenaAVLTree::importFromBinaryFile(filename).isEmpty());
+
+    std::remove(filename.c_str());
+    std::remove(textFile.c_str());
+}
+
 #endif
\ No newline at end of file
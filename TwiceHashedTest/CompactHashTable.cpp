@@ -0,0 +1,103 @@
+#include "CompactHashTable.h"
+#include <cstring>
+
+CompactHashTable::CompactHashTable(size_t initialCapacity) : index(initialCapacity), deadBytes(0) {}
+
+uint32_t CompactHashTable::recordLength(uint32_t handle) const {
+    uint32_t length;
+    std::memcpy(&length, arena.data() + static_cast<size_t>(handle) * kAlign + sizeof(uint32_t), sizeof(length));
+    return length;
+}
+
+bool CompactHashTable::append(int key, const std::string& value, uint32_t& handle) {
+    size_t offset = arena.size();
+    size_t bytes = recordSize(value.size());
+    if ((offset + bytes) / kAlign > UINT32_MAX || value.size() > UINT32_MAX) return false;
+
+    arena.resize(offset + bytes);
+    char* p = arena.data() + offset;
+    uint32_t length = static_cast<uint32_t>(value.size());
+    std::memcpy(p, &key, sizeof(key));
+    std::memcpy(p + sizeof(uint32_t), &length, sizeof(length));
+    if (length > 0) std::memcpy(p + kRecordHeader, value.data(), length);
+    handle = static_cast<uint32_t>(offset / kAlign);
+    return true;
+}
+
+bool CompactHashTable::insert(int key, const std::string& value) {
+    uint32_t handle;
+    if (!append(key, value, handle)) return false;
+
+    uint32_t* existing = index.find(key);
+    if (existing != nullptr) {
+        deadBytes += recordSize(recordLength(*existing));
+        *existing = handle;
+        compactIfNeeded();
+        return true;
+    }
+    if (index.insert(key, handle)) return true;
+
+    arena.resize(static_cast<size_t>(handle) * kAlign);
+    return false;
+}
+
+bool CompactHashTable::find(int key, std::string_view& out) const {
+    const uint32_t* handle = index.find(key);
+    if (handle == nullptr) return false;
+    const char* p = arena.data() + static_cast<size_t>(*handle) * kAlign;
+    out = std::string_view(p + kRecordHeader, recordLength(*handle));
+    return true;
+}
+
+std::string CompactHashTable::search(int key) const {
+    std::string_view value;
+    if (!find(key, value)) return "";
+    return std::string(value);
+}
+
+bool CompactHashTable::remove(int key) {
+    const uint32_t* handle = index.find(key);
+    if (handle == nullptr) return false;
+    deadBytes += recordSize(recordLength(*handle));
+    index.remove(key);
+    compactIfNeeded();
+    return true;
+}
+
+void CompactHashTable::compactIfNeeded() {
+    if (deadBytes >= kMinCompactBytes && deadBytes * 2 > arena.size()) compact();
+}
+
+// Записи идут подряд; живая та, на которую всё ещё указывает индекс
+void CompactHashTable::compact() {
+    if (deadBytes == 0) return;
+
+    std::vector<char> fresh;
+    fresh.reserve(arena.size() - deadBytes);
+    for (size_t offset = 0; offset < arena.size();) {
+        int key;
+        uint32_t length;
+        std::memcpy(&key, arena.data() + offset, sizeof(key));
+        std::memcpy(&length, arena.data() + offset + sizeof(uint32_t), sizeof(length));
+        size_t bytes = recordSize(length);
+
+        uint32_t* handle = index.find(key);
+        if (handle != nullptr && static_cast<size_t>(*handle) * kAlign == offset) {
+            *handle = static_cast<uint32_t>(fresh.size() / kAlign);
+            fresh.insert(fresh.end(), arena.begin() + offset, arena.begin() + offset + bytes);
+        }
+        offset += bytes;
+    }
+    arena.swap(fresh);
+    deadBytes = 0;
+}
+
+void CompactHashTable::clear() {
+    index.clear();
+    arena.clear();
+    deadBytes = 0;
+}
+
+size_t CompactHashTable::memoryUsage() const {
+    return index.memoryUsage() + arena.capacity();
+}
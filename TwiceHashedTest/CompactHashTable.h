@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HashTable.h"
+
+// Компактная таблица int -> строка для очень больших объёмов.
+// Слот индекса — байт ctrl, ключ и 32-битный дескриптор (9 байт), сами
+// строки лежат подряд в одном арене-буфере без отдельных выделений памяти.
+// Арена только дописывается: замена и удаление оставляют мёртвые записи,
+// которые убирает compact() (вызывается и сам, когда мёртвых больше половины).
+class CompactHashTable {
+public:
+    // Запись арены: ключ, длина, байты; выровнена на kAlign
+    static constexpr size_t kAlign = 4;
+    static constexpr size_t kRecordHeader = 2 * sizeof(uint32_t);
+    // Меньше этого мёртвого объёма арена не уплотняется
+    static constexpr size_t kMinCompactBytes = 64 * 1024;
+
+private:
+    BasicHashTable<int, uint32_t> index; // ключ -> дескриптор (смещение / kAlign)
+    std::vector<char> arena;
+    size_t deadBytes;
+
+    static size_t recordSize(size_t length) { return (kRecordHeader + length + kAlign - 1) / kAlign * kAlign; }
+    uint32_t recordLength(uint32_t handle) const;
+    // Дописывает запись; false, если арена вышла за 32-битные дескрипторы
+    bool append(int key, const std::string& value, uint32_t& handle);
+    void compactIfNeeded();
+
+public:
+    CompactHashTable(size_t initialCapacity = 11);
+
+    bool insert(int key, const std::string& value);
+    std::string search(int key) const;
+    // Строка прямо в арене; действительна до следующего изменения таблицы
+    bool find(int key, std::string_view& out) const;
+    bool contains(int key) const { return index.contains(key); }
+    bool remove(int key);
+
+    size_t getSize() const { return index.getSize(); }
+    bool isEmpty() const { return index.isEmpty(); }
+    size_t getCapacity() const { return index.getSlotCount(); }
+
+    // Переписывает арену без мёртвых записей
+    void compact();
+    void clear();
+
+    // Байты индекса и арены (включая резерв вектора и мёртвые записи)
+    size_t memoryUsage() const;
+    size_t getArenaBytes() const { return arena.size(); }
+    size_t getDeadBytes() const { return deadBytes; }
+};
@@ -0,0 +1,224 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include "EpochReclaim.h"
+#include "HashPolicy.h"
+
+// Таблица для нагрузки «почти одни чтения»: поиск не берёт блокировок.
+//
+// Писатели сериализуются мьютексом. Каждый слот защищён счётчиком версии
+// (seqlock): писатель делает его нечётным на время записи, читатель
+// перечитывает слот, если версия изменилась. Значение лежит в куче и
+// публикуется указателем; заменённые значения и старый массив после
+// rehash() уходят в EpochDomain и удаляются только когда ни один читатель
+// их уже не видит. Слоты никогда не переставляются на месте (удаление
+// оставляет надгробие), поэтому цепочки проб читателя не рвутся.
+//
+// Ключ хранится в std::atomic<K>, поэтому K должен быть тривиально копируемым.
+template <typename K, typename V, typename Hash = std::hash<K>, typename Policy = PrimeModPolicy>
+class BasicConcurrentHashTable {
+    static_assert(std::is_trivially_copyable_v<K>, "ConcurrentHashTable needs a trivially copyable key");
+
+public:
+    static constexpr float kMaxLoad = 0.7f;
+
+private:
+    enum State : uint8_t { kEmpty = 0, kFull = 1, kDeleted = 2 };
+
+    struct Slot {
+        std::atomic<uint32_t> version{0};
+        std::atomic<uint8_t> state{kEmpty};
+        std::atomic<K> key{K()};
+        std::atomic<const V*> value{nullptr};
+    };
+
+    struct Array {
+        size_t capacity;
+        Slot* slots;
+
+        explicit Array(size_t c) : capacity(c), slots(new Slot[c]) {}
+        ~Array() { delete[] slots; }
+        Array(const Array&) = delete;
+        Array& operator=(const Array&) = delete;
+    };
+
+    std::atomic<Array*> current;
+    std::atomic<size_t> size;
+    size_t tombstones; // только под writeLock
+    std::mutex writeLock;
+    Hash hasher;
+
+    // Согласованный снимок слота
+    struct SlotView {
+        uint8_t state;
+        K key;
+        const V* value;
+    };
+
+    static SlotView readSlot(const Slot& s) {
+        for (;;) {
+            uint32_t v1 = s.version.load(std::memory_order_acquire);
+            if (v1 & 1) continue; // идёт запись
+            SlotView view{s.state.load(std::memory_order_relaxed), s.key.load(std::memory_order_relaxed),
+                          s.value.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.version.load(std::memory_order_relaxed) == v1) return view;
+        }
+    }
+
+    // Только под writeLock
+    static void writeSlot(Slot& s, uint8_t state, const K& key, const V* value) {
+        uint32_t v = s.version.load(std::memory_order_relaxed);
+        s.version.store(v + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.key.store(key, std::memory_order_relaxed);
+        s.value.store(value, std::memory_order_relaxed);
+        s.state.store(state, std::memory_order_relaxed);
+        s.version.store(v + 2, std::memory_order_release);
+    }
+
+    // Указатель на значение в массиве a или nullptr; вызывать внутри EpochGuard
+    const V* lookup(const Array* a, const K& key) const {
+        size_t h = hasher(key);
+        size_t i = Policy::index(h, a->capacity);
+        size_t step = Policy::step(h, a->capacity);
+        for (size_t attempt = 0; attempt < a->capacity; ++attempt) {
+            SlotView view = readSlot(a->slots[i]);
+            if (view.state == kEmpty) return nullptr;
+            if (view.state == kFull && view.key == key) return view.value;
+            i += step;
+            if (i >= a->capacity) i -= a->capacity;
+        }
+        return nullptr;
+    }
+
+    // Слот ключа (found = true) или первый свободный; только под writeLock
+    static size_t findInsertIndex(const Array* a, const K& key, size_t h, bool& found) {
+        size_t i = Policy::index(h, a->capacity);
+        size_t step = Policy::step(h, a->capacity);
+        size_t firstFree = a->capacity;
+        found = false;
+        for (size_t attempt = 0; attempt < a->capacity; ++attempt) {
+            uint8_t state = a->slots[i].state.load(std::memory_order_relaxed);
+            if (state == kEmpty) return firstFree != a->capacity ? firstFree : i;
+            if (state == kDeleted) {
+                if (firstFree == a->capacity) firstFree = i;
+            } else if (a->slots[i].key.load(std::memory_order_relaxed) == key) {
+                found = true;
+                return i;
+            }
+            i += step;
+            if (i >= a->capacity) i -= a->capacity;
+        }
+        return firstFree;
+    }
+
+    // Новый массив без надгробий; значения переносятся указателями.
+    // Старый массив уходит в EpochDomain. Только под writeLock.
+    void rehash(size_t newCapacity) {
+        Array* a = current.load(std::memory_order_relaxed);
+        Array* next = new Array(newCapacity);
+        for (size_t i = 0; i < a->capacity; ++i) {
+            const Slot& s = a->slots[i];
+            if (s.state.load(std::memory_order_relaxed) != kFull) continue;
+            K key = s.key.load(std::memory_order_relaxed);
+            bool found;
+            size_t j = findInsertIndex(next, key, hasher(key), found);
+            writeSlot(next->slots[j], kFull, key, s.value.load(std::memory_order_relaxed));
+        }
+        tombstones = 0;
+        current.store(next, std::memory_order_release);
+        EpochDomain::instance().retire(a);
+    }
+
+    void growIfNeeded() {
+        Array* a = current.load(std::memory_order_relaxed);
+        size_t live = size.load(std::memory_order_relaxed);
+        if (live + tombstones + 1 < a->capacity * kMaxLoad) return;
+        // Надгробий больше, чем живых — хватит очистки без роста
+        rehash(live < tombstones ? a->capacity : Policy::grow(a->capacity));
+    }
+
+public:
+    BasicConcurrentHashTable(size_t initialCapacity = 11)
+        : current(new Array(Policy::roundCapacity(initialCapacity))), size(0), tombstones(0) {}
+
+    // Разрушение — только когда таблицей уже никто не пользуется
+    ~BasicConcurrentHashTable() {
+        Array* a = current.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < a->capacity; ++i) delete a->slots[i].value.load(std::memory_order_relaxed);
+        delete a;
+    }
+
+    BasicConcurrentHashTable(const BasicConcurrentHashTable&) = delete;
+    BasicConcurrentHashTable& operator=(const BasicConcurrentHashTable&) = delete;
+
+    // Вставка или замена значения (как HashTable::insert)
+    bool insert(const K& key, const V& value) {
+        const V* fresh = new V(value);
+        std::lock_guard<std::mutex> guard(writeLock);
+        growIfNeeded();
+        Array* a = current.load(std::memory_order_relaxed);
+        bool found;
+        size_t i = findInsertIndex(a, key, hasher(key), found);
+        if (i == a->capacity) {
+            delete fresh;
+            return false;
+        }
+        Slot& s = a->slots[i];
+        const V* replaced = found ? s.value.load(std::memory_order_relaxed) : nullptr;
+        if (!found) {
+            if (s.state.load(std::memory_order_relaxed) == kDeleted) --tombstones;
+            size.fetch_add(1, std::memory_order_relaxed);
+        }
+        writeSlot(s, kFull, key, fresh);
+        EpochDomain::instance().retire(const_cast<V*>(replaced));
+        return true;
+    }
+
+    bool remove(const K& key) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        Array* a = current.load(std::memory_order_relaxed);
+        bool found;
+        size_t i = findInsertIndex(a, key, hasher(key), found);
+        if (!found) return false;
+        Slot& s = a->slots[i];
+        const V* removed = s.value.load(std::memory_order_relaxed);
+        writeSlot(s, kDeleted, key, nullptr);
+        ++tombstones;
+        size.fetch_sub(1, std::memory_order_relaxed);
+        EpochDomain::instance().retire(const_cast<V*>(removed));
+        return true;
+    }
+
+    // Поиск без блокировок. Копия значения; для отсутствующего ключа — V()
+    V search(const K& key) const {
+        EpochGuard epoch;
+        const V* value = lookup(current.load(std::memory_order_acquire), key);
+        return value != nullptr ? *value : V();
+    }
+
+    bool tryGet(const K& key, V& out) const {
+        EpochGuard epoch;
+        const V* value = lookup(current.load(std::memory_order_acquire), key);
+        if (value == nullptr) return false;
+        out = *value;
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        EpochGuard epoch;
+        return lookup(current.load(std::memory_order_acquire), key) != nullptr;
+    }
+
+    size_t getSize() const { return size.load(std::memory_order_relaxed); }
+    bool isEmpty() const { return getSize() == 0; }
+    size_t getCapacity() const { return current.load(std::memory_order_acquire)->capacity; }
+};
+
+using ConcurrentHashTable = BasicConcurrentHashTable<int, std::string>;
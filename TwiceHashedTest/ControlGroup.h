@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Групповое сканирование массива ctrl (в стиле Swiss table).
+// Байт ctrl: 0x80 — пусто, 0xFE — удалено, 0x00..0x7F — занято (7 бит хэша).
+// HASHTABLE_NO_SIMD принудительно включает скалярный вариант.
+
+#if !defined(HASHTABLE_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define HASHTABLE_GROUP_AVX2 1
+#elif !defined(HASHTABLE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define HASHTABLE_GROUP_SSE2 1
+#endif
+
+namespace ctrl_byte {
+constexpr uint8_t kEmpty = 0x80;
+constexpr uint8_t kDeleted = 0xFE;
+
+inline bool isFull(uint8_t c) { return c < 0x80; }
+} // namespace ctrl_byte
+
+// Битовая маска совпадений внутри группы: бит i — слот i
+class GroupMask {
+private:
+    uint32_t bits;
+
+public:
+    explicit GroupMask(uint32_t b) : bits(b) {}
+
+    bool any() const { return bits != 0; }
+    int lowest() const { return __builtin_ctz(bits); }
+    void dropLowest() { bits &= bits - 1; }
+};
+
+class ControlGroup {
+public:
+#if defined(HASHTABLE_GROUP_AVX2)
+    static constexpr size_t kWidth = 32;
+#else
+    static constexpr size_t kWidth = 16;
+#endif
+
+private:
+#if defined(HASHTABLE_GROUP_AVX2)
+    __m256i data;
+#elif defined(HASHTABLE_GROUP_SSE2)
+    __m128i data;
+#else
+    const uint8_t* data;
+#endif
+
+public:
+    explicit ControlGroup(const uint8_t* p) {
+#if defined(HASHTABLE_GROUP_AVX2)
+        data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+#elif defined(HASHTABLE_GROUP_SSE2)
+        data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+#else
+        data = p;
+#endif
+    }
+
+    // Слоты, чей ctrl равен тегу
+    GroupMask match(uint8_t tag) const {
+#if defined(HASHTABLE_GROUP_AVX2)
+        __m256i t = _mm256_set1_epi8(static_cast<char>(tag));
+        return GroupMask(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(data, t))));
+#elif defined(HASHTABLE_GROUP_SSE2)
+        __m128i t = _mm_set1_epi8(static_cast<char>(tag));
+        return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, t))));
+#else
+        uint32_t m = 0;
+        for (size_t i = 0; i < kWidth; ++i) {
+            if (data[i] == tag) m |= 1u << i;
+        }
+        return GroupMask(m);
+#endif
+    }
+
+    GroupMask matchEmpty() const { return match(ctrl_byte::kEmpty); }
+
+    // Пустые и удалённые слоты — у обоих старший бит установлен
+    GroupMask matchFree() const {
+#if defined(HASHTABLE_GROUP_AVX2)
+        return GroupMask(static_cast<uint32_t>(_mm256_movemask_epi8(data)));
+#elif defined(HASHTABLE_GROUP_SSE2)
+        return GroupMask(static_cast<uint32_t>(_mm_movemask_epi8(data)));
+#else
+        uint32_t m = 0;
+        for (size_t i = 0; i < kWidth; ++i) {
+            if (!ctrl_byte::isFull(data[i])) m |= 1u << i;
+        }
+        return GroupMask(m);
+#endif
+    }
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Освобождение памяти по эпохам (epoch-based reclamation).
+//
+// Читатель входит в критическую секцию (EpochGuard) и объявляет текущую
+// глобальную эпоху. Писатель, отцепив объект от структуры, не удаляет его
+// сразу, а передаёт в retire(): объект удаляется, когда глобальная эпоха
+// ушла на два шага вперёд — к этому моменту все читатели, которые могли
+// его видеть, уже вышли из секций.
+//
+// Один домен на процесс: потоку выдаётся запись при первом входе
+// и возвращается при завершении потока.
+class EpochDomain {
+public:
+    static constexpr size_t kMaxThreads = 256;
+    // Столько отложенных объектов копится перед попыткой освобождения
+    static constexpr size_t kCollectThreshold = 64;
+
+private:
+    // 0 — поток вне секции, иначе эпоха входа + 1
+    struct alignas(64) Record {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> used{false};
+    };
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    std::atomic<uint64_t> globalEpoch{0};
+    Record records[kMaxThreads];
+    std::mutex retireLock;
+    std::vector<Retired> retired;
+
+    // Запись потока и глубина вложенных секций
+    struct ThreadSlot {
+        Record* record = nullptr;
+        size_t depth = 0;
+
+        ~ThreadSlot() {
+            if (record != nullptr) record->used.store(false, std::memory_order_release);
+        }
+    };
+
+    ThreadSlot& threadSlot() {
+        thread_local ThreadSlot slot;
+        if (slot.record == nullptr) {
+            for (auto& r : records) {
+                bool expected = false;
+                if (!r.used.load(std::memory_order_relaxed) &&
+                    r.used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    slot.record = &r;
+                    break;
+                }
+            }
+            if (slot.record == nullptr) throw std::runtime_error("EpochDomain: too many threads");
+        }
+        return slot;
+    }
+
+    // Эпоха сдвигается, только если все активные читатели уже в текущей
+    bool tryAdvance() {
+        uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+        for (auto& r : records) {
+            uint64_t local = r.epoch.load(std::memory_order_seq_cst);
+            if (local != 0 && local != e + 1) return false;
+        }
+        return globalEpoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    // Под retireLock
+    size_t freeExpired() {
+        uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+        size_t kept = 0;
+        for (const Retired& r : retired) {
+            if (r.epoch + 2 <= e) r.deleter(r.ptr);
+            else retired[kept++] = r;
+        }
+        size_t freed = retired.size() - kept;
+        retired.resize(kept);
+        return freed;
+    }
+
+public:
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    ~EpochDomain() {
+        for (const Retired& r : retired) r.deleter(r.ptr);
+    }
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    void enter() {
+        ThreadSlot& slot = threadSlot();
+        if (slot.depth++ > 0) return;
+        slot.record->epoch.store(globalEpoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        // Объявление эпохи должно стать видно до чтения структуры
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void leave() {
+        ThreadSlot& slot = threadSlot();
+        if (--slot.depth > 0) return;
+        slot.record->epoch.store(0, std::memory_order_release);
+    }
+
+    // Удалить p, когда его гарантированно никто не читает
+    template <typename T>
+    void retire(T* p) {
+        if (p == nullptr) return;
+        std::lock_guard<std::mutex> guard(retireLock);
+        retired.push_back({p, [](void* q) { delete static_cast<T*>(q); },
+                           globalEpoch.load(std::memory_order_seq_cst)});
+        if (retired.size() >= kCollectThreshold) {
+            tryAdvance();
+            freeExpired();
+        }
+    }
+
+    // Попытка сдвинуть эпоху и освободить всё, что можно; число удалённых
+    size_t collect() {
+        std::lock_guard<std::mutex> guard(retireLock);
+        tryAdvance();
+        tryAdvance();
+        return freeExpired();
+    }
+
+    size_t pendingCount() {
+        std::lock_guard<std::mutex> guard(retireLock);
+        return retired.size();
+    }
+};
+
+// Критическая секция читателя: пока guard жив, объекты, отданные
+// в retire() после входа, не удаляются
+class EpochGuard {
+public:
+    EpochGuard() { EpochDomain::instance().enter(); }
+    ~EpochGuard() { EpochDomain::instance().leave(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Политики размещения: как из хэша получить индекс, шаг пробирования
+// и следующую ёмкость. Используются HashTable и CuckooHashTable.
+//
+//   roundCapacity(n) — допустимая ёмкость не меньше n
+//   grow(c), shrink(c) — ёмкость после роста / сжатия
+//   index(h, c)      — основной индекс слота
+//   step(h, c)       — шаг двойного хэширования, взаимно простой с c
+//   altIndex(h, c)   — второй независимый индекс (вторая таблица кукушки)
+
+// Исходное поведение: простые ёмкости и деление по модулю
+struct PrimeModPolicy {
+    // Идентификатор в заголовке снимка (hashtable_snapshot)
+    static constexpr uint32_t kId = 1;
+
+    static size_t nextPrime(size_t n) {
+        if (n < 3) return n < 2 ? 2 : n;
+        if (n % 2 == 0) ++n;
+        for (;; n += 2) {
+            bool prime = true;
+            for (size_t d = 3; d * d <= n; d += 2) {
+                if (n % d == 0) {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime) return n;
+        }
+    }
+
+    static size_t roundCapacity(size_t n) { return nextPrime(n < 3 ? 3 : n); }
+    static size_t grow(size_t c) { return nextPrime(c * 2 + 1); }
+    static size_t shrink(size_t c) { return nextPrime((c - 1) / 2); }
+
+    static size_t index(size_t h, size_t c) { return h % c; }
+    static size_t step(size_t h, size_t c) { return 1 + (h % (c - 1)); }
+    static size_t altIndex(size_t h, size_t c) { return (h / c) % c; }
+};
+
+// Ёмкость — степень двойки, индекс берётся маской от перемешанного хэша.
+// Деления нет, а последовательные и кратные ключи расходятся по таблице.
+struct Pow2MixPolicy {
+    static constexpr uint32_t kId = 2;
+
+    // Финализатор murmur3 (multiply-xorshift)
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ull;
+        x ^= x >> 33;
+        return x;
+    }
+    // Независимая вторая функция: другие константы (splitmix64)
+    static uint64_t mix2(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    static size_t roundCapacity(size_t n) {
+        size_t c = 2;
+        while (c < n) c *= 2;
+        return c;
+    }
+    static size_t grow(size_t c) { return c * 2; }
+    static size_t shrink(size_t c) { return c / 2; }
+
+    static size_t index(size_t h, size_t c) { return static_cast<size_t>(mix(h)) & (c - 1); }
+    // Нечётный шаг взаимно прост со степенью двойки
+    static size_t step(size_t h, size_t c) { return (static_cast<size_t>(mix2(h)) & (c - 1)) | 1; }
+    static size_t altIndex(size_t h, size_t c) { return static_cast<size_t>(mix2(h)) & (c - 1); }
+};
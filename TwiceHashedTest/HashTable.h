@@ -1,51 +1,490 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <fstream>
+#include <iostream>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <string_view>
+#include <cstring>
+#include <vector>
+#include <iterator>
+#include "ControlGroup.h"
+#include "HashPolicy.h"
+#include "TextLoader.h"
 
-class HashNode {
-private:
-    int key;
-    std::string value;
-    bool occupied;
-    bool deleted;
+// Ввод/вывод ключей и значений для текстовых и бинарных файлов
+namespace hashtable_io {
 
-public:
-    HashNode();
-    
-    int getKey() const;
-    const std::string& getValue() const;
-    bool isOccupied() const;
-    bool isDeleted() const;
-
-    void setKey(int k);
-    void setValue(const std::string& v);
-    void markOccupied();
-    void markDeleted();
-    void markEmpty();
+template <typename T>
+void writeText(std::ostream& out, const T& v) { out << v; }
+
+template <typename T>
+bool readTextValue(std::istream& in, T& v) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        std::getline(in, v);
+        if (!v.empty() && v[0] == ' ') v.erase(0, 1);
+        return true;
+    } else {
+        return static_cast<bool>(in >> v);
+    }
+}
+
+template <typename T>
+void writeBinary(std::ostream& out, const T& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "binary I/O needs a trivially copyable type");
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+inline void writeBinary(std::ostream& out, const std::string& v) {
+    int len = static_cast<int>(v.size());
+    out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    if (len > 0) out.write(v.data(), len);
+}
+
+template <typename T>
+bool readBinary(std::istream& in, T& v) {
+    static_assert(std::is_trivially_copyable_v<T>, "binary I/O needs a trivially copyable type");
+    in.read(reinterpret_cast<char*>(&v), sizeof(v));
+    return static_cast<bool>(in);
+}
+
+// Число строк файла (быстрый проход по байтам) — для предварительного reserve()
+inline size_t countLines(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char buffer[1 << 16];
+    size_t lines = 0;
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        lines += std::count(buffer, buffer + in.gcount(), '\n');
+    }
+    return lines;
+}
+
+inline bool readBinary(std::istream& in, std::string& v) {
+    int len;
+    in.read(reinterpret_cast<char*>(&len), sizeof(len));
+    if (!in || len < 0) return false;
+    v.resize(len);
+    if (len > 0) in.read(&v[0], len);
+    return static_cast<bool>(in);
+}
+
+} // namespace hashtable_io
+
+// Снимок, который открывается через mmap и читается без разбора
+// (HashTableView.h). Это сами массивы слотов:
+//   Header | ctrl[capacity] | keys[capacity] | offsets[capacity + 1] | байты значений
+// Каждая секция выровнена по 64 байтам. Значение слота i занимает
+// bytes[offsets[i], offsets[i + 1]), у пустых слотов длина 0.
+// Хэш ключа должен совпадать между процессами (std::hash для целых — да).
+namespace hashtable_snapshot {
+
+constexpr char kMagic[8] = {'H', 'T', 'S', 'N', 'A', 'P', '0', '1'};
+
+struct Header {
+    char magic[8];
+    uint32_t keySize;
+    uint32_t groupWidth; // 0 — двойное хэширование по одному слоту
+    uint32_t policyId;
+    uint32_t probing;    // 0 — двойное хэширование, 1 — группы, 2 — Robin Hood
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t ctrlOffset;
+    uint64_t keysOffset;
+    uint64_t offsetsOffset;
+    uint64_t bytesOffset;
+    uint64_t fileSize;
+};
+
+inline uint64_t align64(uint64_t n) { return (n + 63) & ~uint64_t(63); }
+
+// Значение в снимке: байты строки или объект тривиально копируемого типа
+template <typename V>
+std::string_view bytesOf(const V& v) {
+    if constexpr (std::is_same_v<V, std::string>) {
+        return v;
+    } else {
+        static_assert(std::is_trivially_copyable_v<V>, "snapshot needs std::string or a trivially copyable value");
+        return std::string_view(reinterpret_cast<const char*>(&v), sizeof(V));
+    }
+}
+
+template <typename V>
+V valueFromBytes(std::string_view b) {
+    if constexpr (std::is_same_v<V, std::string>) {
+        return std::string(b);
+    } else {
+        V v;
+        std::memcpy(&v, b.data(), sizeof(V));
+        return v;
+    }
+}
+
+} // namespace hashtable_snapshot
+
+// Прозрачные хэш и сравнение для строковых ключей: find/contains принимают
+// std::string_view и const char* без создания временной std::string
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
 };
 
-class HashTable {
+struct StringEqual {
+    using is_transparent = void;
+    bool operator()(std::string_view a, std::string_view b) const { return a == b; }
+};
+
+// Статистика работы таблицы. Счётчики операций, гистограммы проб и время
+// рехэшей собираются только при -DHASHTABLE_STATS; без него в таблице нет
+// ни полей, ни кода учёта, а getStats() заполняет лишь текущее состояние.
+#ifdef HASHTABLE_STATS
+#include <chrono>
+#define HASHTABLE_STAT(expr) (expr)
+#else
+#define HASHTABLE_STAT(expr) ((void)0)
+#endif
+
+struct HashTableStats {
+    static constexpr size_t kHistogramSize = 16;
+
+    // [n] — поиски, просмотревшие n + 1 слотов (групп); последняя ячейка — все длиннее
+    size_t hitProbes[kHistogramSize] = {};
+    size_t missProbes[kHistogramSize] = {};
+    size_t maxProbe = 0;
+
+    size_t searches = 0;
+    size_t hits = 0;
+    size_t inserts = 0; // новые ключи
+    size_t updates = 0; // вставки существующего ключа
+    size_t removes = 0;
+    size_t failedRemoves = 0;
+    size_t purges = 0;
+    size_t shrinks = 0;
+    // Время каждого рехэша (рост или сжатие) в мкс, вместе с постепенным переносом
+    std::vector<double> rehashMicros;
+
+    // Состояние таблицы на момент снимка
+    size_t live = 0;
+    size_t tombstones = 0;
+    size_t capacity = 0;
+
+    // Вызывается из const-поиска, который ShardedHashTable выполняет под
+    // разделяемой блокировкой параллельно в нескольких потоках, поэтому
+    // счётчики поиска меняются relaxed-атомарно. Остальные поля пишутся
+    // только изменяющими операциями; getStats()/resetStats() — без
+    // параллельных поисков.
+    void recordSearch(size_t probes, bool hit) {
+        __atomic_fetch_add(&searches, 1, __ATOMIC_RELAXED);
+        if (hit) __atomic_fetch_add(&hits, 1, __ATOMIC_RELAXED);
+        size_t bucket = probes == 0 ? 0 : std::min(probes - 1, kHistogramSize - 1);
+        __atomic_fetch_add(&(hit ? hitProbes : missProbes)[bucket], 1, __ATOMIC_RELAXED);
+        size_t seen = __atomic_load_n(&maxProbe, __ATOMIC_RELAXED);
+        while (seen < probes &&
+               !__atomic_compare_exchange_n(&maxProbe, &seen, probes, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+
+    void print(std::ostream& out) const {
+        out << "live " << live << ", tombstones " << tombstones << ", capacity " << capacity << "\n";
+        out << "searches " << searches << " (hits " << hits << "), inserts " << inserts << ", updates " << updates
+            << ", removes " << removes << " (missed " << failedRemoves << ")\n";
+        double total = 0;
+        for (double us : rehashMicros) total += us;
+        out << "rehashes " << rehashMicros.size() << " (" << total << " us), shrinks " << shrinks << ", purges "
+            << purges << "\n";
+        out << "max probe " << maxProbe << "\nprobes  hit       miss\n";
+        for (size_t i = 0; i < kHistogramSize; ++i) {
+            if (hitProbes[i] == 0 && missProbes[i] == 0) continue;
+            out << (i + 1 == kHistogramSize ? ">=" : "  ") << i + 1 << "\t" << hitProbes[i] << "\t" << missProbes[i]
+                << "\n";
+        }
+    }
+};
+
+// Способ пробирования (выбирается при компиляции)
+// Двойное хэширование по одному слоту
+struct DoubleHashProbing {};
+// Сканирование групп ctrl по ControlGroup::kWidth слотов за раз
+struct GroupProbing {};
+// Линейное пробирование Robin Hood: в ctrl занятого слота вместо тега
+// лежит расстояние от домашнего слота, удаление сдвигает хвост назад
+// и надгробий не оставляет
+struct RobinHoodProbing {};
+
+#ifdef HASHTABLE_GROUP_PROBING
+using DefaultProbing = GroupProbing;
+#else
+using DefaultProbing = DoubleHashProbing;
+#endif
+
+// Хэш-таблица с открытой адресацией.
+// Policy задаёт ёмкости и получение индекса/шага из хэша (см. HashPolicy.h).
+// Слоты хранятся по столбцам (SoA): байты ctrl, ключи и значения лежат
+// в отдельных массивах, поэтому цепочка проб читает только ctrl и keys,
+// а массив значений трогается лишь при попадании.
+// В ctrl занятого слота лежат 7 бит хэша, так что ключ сравнивается
+// только при совпадении тега.
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+class BasicHashTableView;
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          typename Probing = DefaultProbing, typename Policy = PrimeModPolicy>
+class BasicHashTable {
+    friend class BasicHashTableView<K, V, Hash, Eq, Probing, Policy>;
+
+public:
+    static constexpr bool kGrouped = std::is_same_v<Probing, GroupProbing>;
+    static constexpr bool kRobinHood = std::is_same_v<Probing, RobinHoodProbing>;
+    // Robin Hood: байт расстояния насыщается здесь, дальше оно вычисляется по хэшу
+    static constexpr uint8_t kMaxDistance = 0x7F;
+    static constexpr uint8_t kEmpty = ctrl_byte::kEmpty;
+    static constexpr uint8_t kDeleted = ctrl_byte::kDeleted;
+
 private:
-    HashNode* table;
-    int size;
-    int capacity;
+    template <typename T, typename = void>
+    struct IsTransparent : std::false_type {};
+    template <typename T>
+    struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+    // Один набор массивов слотов. Ключи и значения конструируются только
+    // в занятых слотах, поэтому новая таблица не трогает память массивов
+    // keys/values до первой вставки.
+    struct Slots {
+        uint8_t* ctrl = nullptr;
+        K* keys = nullptr;
+        V* values = nullptr;
+        size_t capacity = 0;
+    };
+
+    Slots table;
+    // Старые массивы во время постепенного рехэша (ctrl == nullptr — рехэша нет)
+    Slots old;
+    size_t size;        // живые элементы в обоих массивах
+    size_t oldSize;     // из них ещё не перенесены из old
+    size_t migrated;    // сколько слотов old уже просмотрено
+    size_t migrateStep; // слотов old за одну операцию, 0 — рехэш целиком
+    size_t tombstones;
+    size_t minCapacity;  // ниже не сжимается: reserve() или baseCapacity
+    size_t baseCapacity; // ёмкость из конструктора, к ней clear() сбрасывает minCapacity
+    Hash hasher;
+    Eq equal;
+#ifdef HASHTABLE_STATS
+    mutable HashTableStats stats;
 
+    // Добавляет время жизни объекта к target (мкс)
+    struct StatTimer {
+        double& target;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ~StatTimer() {
+            target += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+#endif
+
+    // Тег берётся из старших бит произведения, чтобы не зависеть от индекса
+    static uint8_t tagOf(size_t h) {
+        return static_cast<uint8_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> 57);
+    }
+    size_t roundCapacity(size_t n) const;
+
+    // Поиск по другому типу ключа (Q) разрешён при прозрачных Hash и Eq
+    template <typename H, typename E>
+    using Heterogeneous = std::enable_if_t<IsTransparent<H>::value && IsTransparent<E>::value>;
+
+    // Индекс слота с ключом или s.capacity, если ключа нет. Статический
+    // вариант читает только ctrl и keys — им же пользуется HashTableView
+    // на отображённом в память снимке. length (если задан) получает число
+    // просмотренных слотов (групп).
+    template <typename Q>
+    static size_t probe(const Slots& s, const Q& key, size_t h, const Eq& eq, size_t* length = nullptr);
+    template <typename Q>
+    size_t findIn(const Slots& s, const Q& key, size_t h, size_t* length = nullptr) const {
+        return probe(s, key, h, equal, length);
+    }
+    // Слот значения в table или old; nullptr, если ключа нет
+    template <typename Q>
+    V* findValue(const Q& key) const;
+    // Первый слот цепочки проб хэша h (для предвыборки)
+    size_t homeSlot(const Slots& s, size_t h) const {
+        if constexpr (kGrouped) {
+            return Policy::index(h, s.capacity / ControlGroup::kWidth) * ControlGroup::kWidth;
+        } else {
+            return Policy::index(h, s.capacity);
+        }
+    }
+    // Общая часть вставок: если ключа нет, конструирует значение из args
+    template <typename KArg, typename... Args>
+    std::pair<V*, bool> emplaceImpl(KArg&& key, Args&&... args);
+    // Первый незанятый (пустой или удалённый) слот на пути проб хэша h
+    size_t findFirstFree(const Slots& s, size_t h) const;
+    // Слот для вставки в table: найденный ключ (found = true) или первый свободный
+    size_t findInsertIndex(const K& key, size_t h, bool& found) const;
+    // Освобождает слот; true, если на его месте осталось надгробие
+    bool eraseAt(Slots& s, size_t i);
+    // Занимает найденный для вставки слот i таблицы: пишет ctrl, а в режиме
+    // Robin Hood сдвигает вперёд хвост кластера. Ключ и значение
+    // конструирует вызывающий.
+    void claim(size_t i, size_t h);
+
+    static size_t nextSlot(size_t i, size_t capacity) { return i + 1 == capacity ? 0 : i + 1; }
+    static uint8_t distanceByte(size_t d) { return d < kMaxDistance ? static_cast<uint8_t>(d) : kMaxDistance; }
+    // Расстояние занятого слота от домашнего (Robin Hood)
+    size_t distanceAt(const Slots& s, size_t i) const {
+        if (s.ctrl[i] < kMaxDistance) return s.ctrl[i];
+        size_t home = Policy::index(hasher(s.keys[i]), s.capacity);
+        return i >= home ? i - home : i + s.capacity - home;
+    }
+    // Сколько слотов (групп) просматривает поиск ключа, лежащего в слоте i
+    size_t probeLengthAt(size_t i) const;
+    // Вставка без проверки заполненности: место заранее обеспечено reserve()
+    template <typename KArg, typename VArg>
+    bool place(KArg&& key, VArg&& value);
+    // Наименьшая ёмкость, в которую n элементов входят без роста
+    size_t capacityFor(size_t n) const { return roundCapacity(static_cast<size_t>(n / kMaxLoad) + 1); }
+
+    static Slots allocate(size_t capacity);
+    static void release(Slots& s);
+    template <typename KArg, typename VArg>
+    static void construct(Slots& s, size_t i, KArg&& key, VArg&& value) {
+        new (s.keys + i) K(std::forward<KArg>(key));
+        new (s.values + i) V(std::forward<VArg>(value));
+    }
+    static void destroy(Slots& s, size_t i) {
+        s.keys[i].~K();
+        s.values[i].~V();
+    }
+    bool isMigrating() const { return old.ctrl != nullptr; }
+    void migrate(size_t slots);
     void rehash();
+    void resize(size_t newCapacity);
+    // Рост, очистка надгробий или сжатие по занятости таблицы
+    void growIfNeeded();
+    void shrinkIfNeeded();
+
+    // Обход живых элементов обоих массивов
+    template <typename F>
+    void forEachEntry(F f) const;
 
 public:
-    HashTable(int initialCapacity = 11);
-    ~HashTable();
+    // Живые + удалённые слоты выше этой доли — рост или очистка надгробий
+    static constexpr float kMaxLoad = 0.7f;
+    // Живые слоты ниже этой доли — таблица сжимается вдвое
+    static constexpr float kMinLoad = 0.15f;
+
+    BasicHashTable(size_t initialCapacity = 11);
+    ~BasicHashTable();
+
+    BasicHashTable(const BasicHashTable&) = delete;
+    BasicHashTable& operator=(const BasicHashTable&) = delete;
+
+    bool insert(const K& key, const V& value);
+    // Копия значения; для отсутствующего ключа — V()
+    V search(const K& key) const;
+    bool remove(const K& key);
 
-    bool insert(int key, const std::string& value);
-    std::string search(int key) const;
-    bool remove(int key);
+    // Указатель на значение без копирования; nullptr, если ключа нет.
+    // Указатель действителен до следующей вставки или удаления.
+    V* find(const K& key) { return findValue(key); }
+    const V* find(const K& key) const { return findValue(key); }
+    template <typename Q, typename H = Hash, typename E = Eq, typename = Heterogeneous<H, E>>
+    V* find(const Q& key) { return findValue(key); }
+    template <typename Q, typename H = Hash, typename E = Eq, typename = Heterogeneous<H, E>>
+    const V* find(const Q& key) const { return findValue(key); }
 
-    int getSize() const { return size; }
+    bool contains(const K& key) const { return findValue(key) != nullptr; }
+    template <typename Q, typename H = Hash, typename E = Eq, typename = Heterogeneous<H, E>>
+    bool contains(const Q& key) const { return findValue(key) != nullptr; }
+
+    // Пакетный поиск: out[i] = find(keys[i]). Сначала считаются хэши всей
+    // пачки и запрашиваются (prefetch) начальные слоты, потом разбираются
+    // цепочки проб — промахи кэша разных ключей перекрываются.
+    // Возвращает число найденных ключей.
+    static constexpr size_t kBatchChunk = 64;
+    size_t searchBatch(const K* keys, size_t n, const V** out) const;
+
+    // Вставляет V(args...), если ключа нет; существующее значение не трогает.
+    // Возвращает указатель на значение и признак вставки.
+    template <typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        return emplaceImpl(key, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    std::pair<V*, bool> try_emplace(K&& key, Args&&... args) {
+        return emplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    // Вставляет или перезаписывает значение, перемещая аргументы
+    template <typename M>
+    std::pair<V*, bool> insert_or_assign(const K& key, M&& value);
+    template <typename M>
+    std::pair<V*, bool> insert_or_assign(K&& key, M&& value);
+
+    size_t getSize() const { return size; }
     bool isEmpty() const { return size == 0; }
-    int getCapacity() const { return capacity; }
-    float getLoadFactor() const { return static_cast<float>(size) / capacity; }
+    // Сигнатура исходной таблицы; для таблиц больше INT_MAX слотов — getSlotCount()
+    int getCapacity() const { return static_cast<int>(table.capacity); }
+    size_t getSlotCount() const { return table.capacity; }
+    float getLoadFactor() const { return static_cast<float>(size) / table.capacity; }
+    size_t getTombstoneCount() const { return tombstones; }
+    // Доля слотов, которые удлиняют цепочки проб (живые + надгробия)
+    float getOccupancy() const { return static_cast<float>(size + tombstones) / table.capacity; }
+
+    // Убирает все надгробия без изменения ёмкости (можно вызывать по расписанию)
+    void purgeTombstones();
+
+    // Длина проб успешного поиска по всем ключам table: слоты для
+    // одиночного пробирования, группы для GroupProbing
+    struct ProbeStats {
+        double mean = 0;
+        size_t max = 0;
+    };
+    ProbeStats probeStats() const;
+
+#ifdef HASHTABLE_STATS
+    static constexpr bool kStatsEnabled = true;
+#else
+    static constexpr bool kStatsEnabled = false;
+#endif
+    // Снимок статистики (см. HashTableStats)
+    HashTableStats getStats() const;
+    void resetStats() {
+#ifdef HASHTABLE_STATS
+        stats = HashTableStats();
+        // Незаконченный постепенный рехэш дописывает время в последнюю запись
+        if (isMigrating()) stats.rehashMicros.push_back(0);
+#endif
+    }
+
+    // Память таблицы в байтах: массивы слотов (включая старые при рехэше)
+    // и куча, занятая длинными строками ключей и значений
+    size_t memoryUsage() const;
+
+    // Ёмкость под n элементов: до n вставок рехэша не будет, и таблица
+    // не сжимается ниже этой ёмкости до clear()
+    void reserve(size_t n);
+    // Заменяет содержимое n парами (keys[i], values[i]) за одно выделение
+    // памяти; при повторе ключа остаётся последнее значение
+    void bulkBuild(const K* keys, const V* values, size_t n);
+    // То же для диапазона пар (first, second)
+    template <typename It>
+    void bulkBuild(It first, It last);
+
+    // Постепенный рехэш: старые и новые массивы живут вместе, каждая
+    // вставка/удаление переносит slotsPerOp слотов старого массива,
+    // поиск смотрит в оба. 0 — рехэш целиком за один вызов.
+    void setIncrementalRehash(size_t slotsPerOp) { migrateStep = slotsPerOp; }
+    bool isRehashing() const { return isMigrating(); }
+    // Доводит начатый постепенный рехэш до конца
+    void finishRehash();
 
     void print() const;
+    // Удаляет все пары и снимает резерв reserve(); массивы остаются
+    // и сжимаются последующими удалениями
     void clear();
 
     void readFromFile(const std::string& filename);
@@ -54,6 +493,848 @@ public:
     bool serializeToBinary(const std::string& filename) const;
     bool deserializeFromBinary(const std::string& filename);
 
+    // Снимок для BasicHashTableView (формат — hashtable_snapshot).
+    // Ключ должен быть тривиально копируемым.
+    bool writeSnapshot(const std::string& filename) const;
+
+    static bool isFullSlot(uint8_t c) { return ctrl_byte::isFull(c); }
+
     // Для тестов
-    const HashNode* getTable() const { return table; }
+    const uint8_t* getControl() const { return table.ctrl; }
+    const K* getKeys() const { return table.keys; }
+    const V* getValues() const { return table.values; }
 };
+
+using HashTable = BasicHashTable<int, std::string>;
+
+extern template class BasicHashTable<int, std::string>;
+
+
+// Число групп — всегда степень двойки: треугольное пробирование обходит
+// их все. Для двойного хэширования ёмкость выбирает Policy так, чтобы шаг
+// был взаимно прост с ней (простое число или нечётный шаг при 2^k).
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::roundCapacity(size_t n) const {
+    if constexpr (kGrouped) {
+        size_t groups = 1;
+        while (groups * ControlGroup::kWidth < n) groups *= 2;
+        return groups * ControlGroup::kWidth;
+    } else {
+        return Policy::roundCapacity(n);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+BasicHashTable<K, V, Hash, Eq, Probing, Policy>::BasicHashTable(size_t initialCapacity)
+    : size(0), oldSize(0), migrated(0), migrateStep(0), tombstones(0) {
+    table = allocate(roundCapacity(initialCapacity));
+    minCapacity = baseCapacity = table.capacity;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+BasicHashTable<K, V, Hash, Eq, Probing, Policy>::~BasicHashTable() {
+    release(table);
+    release(old);
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+typename BasicHashTable<K, V, Hash, Eq, Probing, Policy>::Slots
+BasicHashTable<K, V, Hash, Eq, Probing, Policy>::allocate(size_t capacity) {
+    Slots s;
+    s.capacity = capacity;
+    s.ctrl = new uint8_t[capacity];
+    s.keys = std::allocator<K>().allocate(capacity);
+    s.values = std::allocator<V>().allocate(capacity);
+    std::fill(s.ctrl, s.ctrl + capacity, kEmpty);
+    return s;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::release(Slots& s) {
+    if (s.ctrl == nullptr) return;
+    for (size_t i = 0; i < s.capacity; ++i) {
+        if (isFullSlot(s.ctrl[i])) destroy(s, i);
+    }
+    delete[] s.ctrl;
+    std::allocator<K>().deallocate(s.keys, s.capacity);
+    std::allocator<V>().deallocate(s.values, s.capacity);
+    s = Slots();
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename Q>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::probe(const Slots& s, const Q& key, size_t h, const Eq& eq,
+                                                             size_t* length) {
+    uint8_t tag = tagOf(h);
+    auto done = [length](size_t i, size_t probes) {
+        if (length != nullptr) *length = probes;
+        return i;
+    };
+
+    if constexpr (kGrouped) {
+        const size_t mask = s.capacity / ControlGroup::kWidth - 1;
+        size_t g = Policy::index(h, mask + 1);
+        for (size_t attempt = 0; attempt <= mask; ++attempt) {
+            size_t base = g * ControlGroup::kWidth;
+            ControlGroup group(s.ctrl + base);
+            for (GroupMask m = group.match(tag); m.any(); m.dropLowest()) {
+                size_t i = base + m.lowest();
+                if (eq(s.keys[i], key)) return done(i, attempt + 1);
+            }
+            if (group.matchEmpty().any()) return done(s.capacity, attempt + 1);
+            g = (g + attempt + 1) & mask;
+        }
+        return done(s.capacity, mask + 1);
+    } else if constexpr (kRobinHood) {
+        size_t i = Policy::index(h, s.capacity);
+        for (size_t d = 0; d < s.capacity; ++d) {
+            uint8_t c = s.ctrl[i];
+            if (c == kEmpty) return done(s.capacity, d + 1);
+            if (c < kMaxDistance) {
+                // Соседи упорядочены по домашнему слоту: дальше ключа быть не может
+                if (c < d) return done(s.capacity, d + 1);
+                if (c == d && eq(s.keys[i], key)) return done(i, d + 1);
+            } else if (c == kMaxDistance && d >= kMaxDistance && eq(s.keys[i], key)) {
+                return done(i, d + 1);
+            }
+            i = nextSlot(i, s.capacity);
+        }
+        return done(s.capacity, s.capacity);
+    } else {
+        size_t step = Policy::step(h, s.capacity);
+        size_t i = Policy::index(h, s.capacity);
+        for (size_t attempt = 0; attempt < s.capacity; ++attempt) {
+            if (s.ctrl[i] == kEmpty) return done(s.capacity, attempt + 1);
+            if (s.ctrl[i] == tag && eq(s.keys[i], key)) return done(i, attempt + 1);
+            i += step;
+            if (i >= s.capacity) i -= s.capacity;
+        }
+        return done(s.capacity, s.capacity);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::findFirstFree(const Slots& s, size_t h) const {
+    if constexpr (kGrouped) {
+        const size_t mask = s.capacity / ControlGroup::kWidth - 1;
+        size_t g = Policy::index(h, mask + 1);
+        for (size_t attempt = 0; attempt <= mask; ++attempt) {
+            size_t base = g * ControlGroup::kWidth;
+            GroupMask free = ControlGroup(s.ctrl + base).matchFree();
+            if (free.any()) return base + free.lowest();
+            g = (g + attempt + 1) & mask;
+        }
+        return s.capacity;
+    } else if constexpr (kRobinHood) {
+        // Ключа в s нет: место — первый пустой слот или первый более «богатый» сосед
+        size_t i = Policy::index(h, s.capacity);
+        for (size_t d = 0; d < s.capacity; ++d) {
+            if (!isFullSlot(s.ctrl[i]) || distanceAt(s, i) < d) return i;
+            i = nextSlot(i, s.capacity);
+        }
+        return s.capacity;
+    } else {
+        size_t step = Policy::step(h, s.capacity);
+        size_t i = Policy::index(h, s.capacity);
+        for (size_t attempt = 0; attempt < s.capacity; ++attempt) {
+            if (!isFullSlot(s.ctrl[i])) return i;
+            i += step;
+            if (i >= s.capacity) i -= s.capacity;
+        }
+        return s.capacity;
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::findInsertIndex(const K& key, size_t h, bool& found) const {
+    if constexpr (kGrouped) {
+        size_t i = findIn(table, key, h);
+        found = i != table.capacity;
+        if (found) return i;
+        return findFirstFree(table, h);
+    } else if constexpr (kRobinHood) {
+        size_t i = Policy::index(h, table.capacity);
+        found = false;
+        for (size_t d = 0; d < table.capacity; ++d) {
+            if (!isFullSlot(table.ctrl[i])) return i;
+            size_t dist = distanceAt(table, i);
+            if (dist < d) return i;
+            if (dist == d && equal(table.keys[i], key)) {
+                found = true;
+                return i;
+            }
+            i = nextSlot(i, table.capacity);
+        }
+        return table.capacity;
+    } else {
+        uint8_t tag = tagOf(h);
+        size_t step = Policy::step(h, table.capacity);
+        size_t i = Policy::index(h, table.capacity);
+        size_t firstFree = table.capacity;
+
+        found = false;
+        for (size_t attempt = 0; attempt < table.capacity; ++attempt) {
+            if (table.ctrl[i] == kEmpty) {
+                return firstFree != table.capacity ? firstFree : i;
+            }
+            if (table.ctrl[i] == kDeleted) {
+                if (firstFree == table.capacity) firstFree = i;
+            } else if (table.ctrl[i] == tag && equal(table.keys[i], key)) {
+                found = true;
+                return i;
+            }
+            i += step;
+            if (i >= table.capacity) i -= table.capacity;
+        }
+        return firstFree;
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::eraseAt(Slots& s, size_t i) {
+    if constexpr (kGrouped) {
+        // Если в группе уже есть пустой слот, пробы через неё не проходили —
+        // надгробие не нужно
+        size_t base = i - i % ControlGroup::kWidth;
+        s.ctrl[i] = ControlGroup(s.ctrl + base).matchEmpty().any() ? kEmpty : kDeleted;
+    } else if constexpr (kRobinHood) {
+        // Сдвиг назад: соседи, стоящие не на своём месте, подтягиваются на
+        // один слот, пока не встретится пустой слот или элемент дома
+        destroy(s, i);
+        for (size_t j = nextSlot(i, s.capacity); isFullSlot(s.ctrl[j]) && s.ctrl[j] != 0;
+             j = nextSlot(j, s.capacity)) {
+            s.ctrl[i] = distanceByte(distanceAt(s, j) - 1);
+            construct(s, i, std::move(s.keys[j]), std::move(s.values[j]));
+            destroy(s, j);
+            i = j;
+        }
+        s.ctrl[i] = kEmpty;
+        return false;
+    } else {
+        s.ctrl[i] = kDeleted;
+    }
+    destroy(s, i);
+    return s.ctrl[i] == kDeleted;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::claim(size_t i, size_t h) {
+    if constexpr (kRobinHood) {
+        // Кластер от i до ближайшего пустого слота сдвигается на один слот
+        // вперёд: порядок по домашним слотам сохраняется, новый ключ встаёт в i
+        const size_t cap = table.capacity;
+        size_t end = i;
+        while (isFullSlot(table.ctrl[end])) end = nextSlot(end, cap);
+        for (size_t j = end; j != i;) {
+            size_t prev = j == 0 ? cap - 1 : j - 1;
+            uint8_t c = table.ctrl[prev];
+            table.ctrl[j] = c < kMaxDistance ? c + 1 : kMaxDistance;
+            construct(table, j, std::move(table.keys[prev]), std::move(table.values[prev]));
+            destroy(table, prev);
+            j = prev;
+        }
+        size_t home = Policy::index(h, cap);
+        table.ctrl[i] = distanceByte(i >= home ? i - home : i + cap - home);
+    } else {
+        if (table.ctrl[i] == kDeleted) --tombstones;
+        table.ctrl[i] = tagOf(h);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::probeLengthAt(size_t i) const {
+    size_t h = hasher(table.keys[i]);
+    if constexpr (kGrouped) {
+        const size_t mask = table.capacity / ControlGroup::kWidth - 1;
+        size_t g = Policy::index(h, mask + 1);
+        size_t length = 1;
+        for (size_t attempt = 0; g != i / ControlGroup::kWidth; ++attempt, ++length) {
+            g = (g + attempt + 1) & mask;
+        }
+        return length;
+    } else if constexpr (kRobinHood) {
+        return distanceAt(table, i) + 1;
+    } else {
+        size_t step = Policy::step(h, table.capacity);
+        size_t j = Policy::index(h, table.capacity);
+        size_t length = 1;
+        for (; j != i; ++length) {
+            j += step;
+            if (j >= table.capacity) j -= table.capacity;
+        }
+        return length;
+    }
+}
+
+// Строка без SSO держит данные вне самого объекта
+template <typename T>
+size_t heapBytesOf(const T& v) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        const char* object = reinterpret_cast<const char*>(&v);
+        bool inline_ = v.data() >= object && v.data() < object + sizeof(v);
+        return inline_ ? 0 : v.capacity() + 1;
+    } else {
+        return 0;
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::memoryUsage() const {
+    const size_t perSlot = 1 + sizeof(K) + sizeof(V);
+    size_t bytes = sizeof(*this) + (table.capacity + old.capacity) * perSlot;
+    forEachEntry([&](const K& key, const V& value) { bytes += heapBytesOf(key) + heapBytesOf(value); });
+    return bytes;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+typename BasicHashTable<K, V, Hash, Eq, Probing, Policy>::ProbeStats
+BasicHashTable<K, V, Hash, Eq, Probing, Policy>::probeStats() const {
+    ProbeStats result;
+    size_t total = 0, count = 0;
+    for (size_t i = 0; i < table.capacity; ++i) {
+        if (!isFullSlot(table.ctrl[i])) continue;
+        size_t length = probeLengthAt(i);
+        total += length;
+        result.max = std::max(result.max, length);
+        ++count;
+    }
+    if (count > 0) result.mean = static_cast<double>(total) / count;
+    return result;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+HashTableStats BasicHashTable<K, V, Hash, Eq, Probing, Policy>::getStats() const {
+    HashTableStats snapshot;
+#ifdef HASHTABLE_STATS
+    snapshot = stats;
+#endif
+    snapshot.live = size;
+    snapshot.tombstones = tombstones;
+    snapshot.capacity = table.capacity;
+    return snapshot;
+}
+
+// Переносит очередные slots слотов old в table. Перенесённый слот
+// помечается kDeleted, чтобы цепочки оставшихся ключей в old не рвались.
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::migrate(size_t slots) {
+#ifdef HASHTABLE_STATS
+    StatTimer timer{stats.rehashMicros.back()};
+#endif
+    size_t end = migrated + slots;
+    if (end > old.capacity) end = old.capacity;
+
+    for (; migrated < end && oldSize > 0; ++migrated) {
+        if (!isFullSlot(old.ctrl[migrated])) continue;
+
+        size_t h = hasher(old.keys[migrated]);
+        size_t j = findFirstFree(table, h);
+        claim(j, h);
+        construct(table, j, std::move(old.keys[migrated]), std::move(old.values[migrated]));
+        destroy(old, migrated);
+        old.ctrl[migrated] = kDeleted;
+        --oldSize;
+    }
+
+    if (oldSize == 0 || migrated == old.capacity) {
+        release(old);
+        migrated = 0;
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::finishRehash() {
+    if (isMigrating()) migrate(old.capacity);
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::rehash() {
+    resize(kGrouped ? table.capacity * 2 : Policy::grow(table.capacity));
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::resize(size_t newCapacity) {
+    finishRehash();
+    HASHTABLE_STAT(stats.rehashMicros.push_back(0));
+
+    old = table;
+    oldSize = size;
+    migrated = 0;
+    {
+#ifdef HASHTABLE_STATS
+        StatTimer timer{stats.rehashMicros.back()};
+#endif
+        table = allocate(roundCapacity(newCapacity));
+    }
+    tombstones = 0;
+
+    if (migrateStep == 0) finishRehash();
+}
+
+// Очистка на месте: занятые слоты временно помечаются kDeleted
+// ("ещё не размещён"), надгробия — kEmpty, затем каждый помеченный ключ
+// переезжает в первый незанятый слот своей цепочки
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::purgeTombstones() {
+    if (tombstones == 0) return;
+    HASHTABLE_STAT(++stats.purges);
+
+    uint8_t* ctrl = table.ctrl;
+    K* keys = table.keys;
+    V* values = table.values;
+    // Надгробия уже разрушены, kDeleted здесь — только живые ключи
+    for (size_t i = 0; i < table.capacity; ++i) {
+        ctrl[i] = isFullSlot(ctrl[i]) ? kDeleted : kEmpty;
+    }
+
+    for (size_t i = 0; i < table.capacity; ++i) {
+        if (ctrl[i] != kDeleted) continue;
+
+        size_t h = hasher(keys[i]);
+        size_t j = findFirstFree(table, h);
+        bool samePlace = kGrouped ? (i / ControlGroup::kWidth == j / ControlGroup::kWidth) : (i == j);
+        if (samePlace) {
+            ctrl[i] = tagOf(h);
+        } else if (ctrl[j] == kEmpty) {
+            ctrl[j] = tagOf(h);
+            construct(table, j, std::move(keys[i]), std::move(values[i]));
+            destroy(table, i);
+            ctrl[i] = kEmpty;
+        } else {
+            // В j лежит ещё не размещённый ключ: меняемся и обрабатываем i заново
+            ctrl[j] = tagOf(h);
+            std::swap(keys[i], keys[j]);
+            std::swap(values[i], values[j]);
+            --i;
+        }
+    }
+    tombstones = 0;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::growIfNeeded() {
+    // Непереехавшие элементы old тоже займут место в table
+    if (static_cast<float>(size + tombstones) < table.capacity * kMaxLoad) return;
+
+    finishRehash();
+    // Если больше половины занятого — надгробия, хватит очистки на месте
+    if (size < tombstones) {
+        purgeTombstones();
+    } else {
+        rehash();
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::shrinkIfNeeded() {
+    if (table.capacity <= minCapacity || static_cast<float>(size) >= table.capacity * kMinLoad) return;
+
+    size_t newCapacity = kGrouped ? table.capacity / 2 : Policy::shrink(table.capacity);
+    HASHTABLE_STAT(++stats.shrinks);
+    resize(newCapacity < minCapacity ? minCapacity : newCapacity);
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename KArg, typename... Args>
+std::pair<V*, bool> BasicHashTable<K, V, Hash, Eq, Probing, Policy>::emplaceImpl(KArg&& key, Args&&... args) {
+    if (isMigrating()) migrate(migrateStep);
+    growIfNeeded();
+
+    size_t h = hasher(key);
+    bool found;
+    size_t i = findInsertIndex(key, h, found);
+    if (i == table.capacity) return {nullptr, false};
+
+    if (found) {
+        HASHTABLE_STAT(++stats.updates);
+        return {&table.values[i], false};
+    }
+    if (isMigrating()) {
+        size_t j = findIn(old, key, h);
+        if (j != old.capacity) {
+            HASHTABLE_STAT(++stats.updates);
+            return {&old.values[j], false};
+        }
+    }
+
+    HASHTABLE_STAT(++stats.inserts);
+    claim(i, h);
+    new (table.keys + i) K(std::forward<KArg>(key));
+    new (table.values + i) V(std::forward<Args>(args)...);
+    ++size;
+    return {&table.values[i], true};
+}
+
+// Аргумент value расходуется только одной из веток: либо конструирует
+// новое значение, либо присваивается существующему
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename M>
+std::pair<V*, bool> BasicHashTable<K, V, Hash, Eq, Probing, Policy>::insert_or_assign(const K& key, M&& value) {
+    std::pair<V*, bool> r = emplaceImpl(key, std::forward<M>(value));
+    if (r.first && !r.second) *r.first = std::forward<M>(value);
+    return r;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename M>
+std::pair<V*, bool> BasicHashTable<K, V, Hash, Eq, Probing, Policy>::insert_or_assign(K&& key, M&& value) {
+    std::pair<V*, bool> r = emplaceImpl(std::move(key), std::forward<M>(value));
+    if (r.first && !r.second) *r.first = std::forward<M>(value);
+    return r;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::insert(const K& key, const V& value) {
+    return insert_or_assign(key, value).first != nullptr;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename Q>
+V* BasicHashTable<K, V, Hash, Eq, Probing, Policy>::findValue(const Q& key) const {
+    size_t h = hasher(key);
+    size_t probes = 0, oldProbes = 0;
+    V* value = nullptr;
+    size_t i = findIn(table, key, h, kStatsEnabled ? &probes : nullptr);
+    if (i != table.capacity) {
+        value = &table.values[i];
+    } else if (isMigrating()) {
+        i = findIn(old, key, h, kStatsEnabled ? &oldProbes : nullptr);
+        if (i != old.capacity) value = &old.values[i];
+    }
+    HASHTABLE_STAT(stats.recordSearch(probes + oldProbes, value != nullptr));
+    return value;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+size_t BasicHashTable<K, V, Hash, Eq, Probing, Policy>::searchBatch(const K* keys, size_t n, const V** out) const {
+    size_t hashes[kBatchChunk];
+    size_t found = 0;
+
+    for (size_t start = 0; start < n; start += kBatchChunk) {
+        size_t count = std::min(kBatchChunk, n - start);
+
+        for (size_t j = 0; j < count; ++j) {
+            hashes[j] = hasher(keys[start + j]);
+            size_t i = homeSlot(table, hashes[j]);
+            __builtin_prefetch(table.ctrl + i);
+            __builtin_prefetch(table.keys + i);
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            const K& key = keys[start + j];
+            const V* value = nullptr;
+            size_t probes = 0, oldProbes = 0;
+            size_t i = findIn(table, key, hashes[j], kStatsEnabled ? &probes : nullptr);
+            if (i != table.capacity) {
+                value = &table.values[i];
+            } else if (isMigrating()) {
+                i = findIn(old, key, hashes[j], kStatsEnabled ? &oldProbes : nullptr);
+                if (i != old.capacity) value = &old.values[i];
+            }
+            HASHTABLE_STAT(stats.recordSearch(probes + oldProbes, value != nullptr));
+            if (value != nullptr) {
+                __builtin_prefetch(value);
+                ++found;
+            }
+            out[start + j] = value;
+        }
+    }
+    return found;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+V BasicHashTable<K, V, Hash, Eq, Probing, Policy>::search(const K& key) const {
+    const V* value = findValue(key);
+    return value ? *value : V();
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::remove(const K& key) {
+    if (isMigrating()) migrate(migrateStep);
+
+    size_t h = hasher(key);
+    size_t i = findIn(table, key, h);
+    if (i != table.capacity) {
+        if (eraseAt(table, i)) ++tombstones;
+    } else {
+        if (isMigrating()) i = findIn(old, key, h);
+        if (!isMigrating() || i == old.capacity) {
+            HASHTABLE_STAT(++stats.failedRemoves);
+            return false;
+        }
+        old.ctrl[i] = kDeleted;
+        destroy(old, i);
+        --oldSize;
+    }
+    --size;
+    HASHTABLE_STAT(++stats.removes);
+
+    shrinkIfNeeded();
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename F>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::forEachEntry(F f) const {
+    for (size_t i = 0; i < table.capacity; ++i) {
+        if (isFullSlot(table.ctrl[i])) f(table.keys[i], table.values[i]);
+    }
+    for (size_t i = 0; i < old.capacity; ++i) {
+        if (isFullSlot(old.ctrl[i])) f(old.keys[i], old.values[i]);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::print() const {
+    auto printSlots = [](const Slots& s) {
+        for (size_t i = 0; i < s.capacity; ++i) {
+            std::cout << "[" << i << "]: ";
+            if (isFullSlot(s.ctrl[i])) {
+                std::cout << s.keys[i] << " -> " << s.values[i];
+            } else if (s.ctrl[i] == kDeleted) {
+                std::cout << "DELETED";
+            } else {
+                std::cout << "EMPTY";
+            }
+            std::cout << std::endl;
+        }
+    };
+
+    printSlots(table);
+    if (isMigrating()) {
+        std::cout << "Rehashing, old slots:" << std::endl;
+        printSlots(old);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::clear() {
+    release(old);
+    for (size_t i = 0; i < table.capacity; ++i) {
+        if (isFullSlot(table.ctrl[i])) destroy(table, i);
+        table.ctrl[i] = kEmpty;
+    }
+    size = 0;
+    oldSize = 0;
+    migrated = 0;
+    tombstones = 0;
+    minCapacity = baseCapacity;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename KArg, typename VArg>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::place(KArg&& key, VArg&& value) {
+    size_t h = hasher(key);
+    bool found;
+    size_t j = findInsertIndex(key, h, found);
+    if (j == table.capacity) return false;
+    if (found) {
+        table.values[j] = std::forward<VArg>(value);
+    } else {
+        claim(j, h);
+        construct(table, j, std::forward<KArg>(key), std::forward<VArg>(value));
+        ++size;
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::reserve(size_t n) {
+    finishRehash();
+    size_t needed = capacityFor(n);
+    minCapacity = std::max(minCapacity, needed);
+    if (needed <= table.capacity) return;
+
+    // Сразу целиком, даже при постепенном рехэше
+    size_t step = migrateStep;
+    migrateStep = 0;
+    resize(needed);
+    migrateStep = step;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::bulkBuild(const K* keys, const V* values, size_t n) {
+    clear();
+    reserve(n);
+    for (size_t i = 0; i < n; ++i) place(keys[i], values[i]);
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+template <typename It>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::bulkBuild(It first, It last) {
+    clear();
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                    typename std::iterator_traits<It>::iterator_category>) {
+        reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) place(first->first, first->second);
+    } else {
+        // Однопроходный итератор: размер заранее неизвестен
+        for (; first != last; ++first) insert(first->first, first->second);
+    }
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::readFromFile(const std::string& filename) {
+    clear();
+
+    // Целые ключи: mmap и параллельный разбор, затем вставка одной пачкой
+    if constexpr (hashtable_io::kFastText<K, V>) {
+        std::vector<hashtable_io::TextChunk<K, V>> chunks;
+        if (hashtable_io::parseMappedText(filename, chunks)) {
+            size_t total = 0;
+            for (const auto& chunk : chunks) total += chunk.pairs.size();
+            reserve(total);
+            for (auto& chunk : chunks) {
+                for (auto& kv : chunk.pairs) place(std::move(kv.first), std::move(kv.second));
+                if (chunk.stopped) break;
+            }
+            return;
+        }
+    }
+
+    std::ifstream in(filename);
+    if (!in.is_open()) return;
+    // Одна строка — одна пара: ёмкость выделяется один раз
+    reserve(hashtable_io::countLines(filename));
+
+    K key;
+    V value;
+    while (in >> key) {
+        if (!hashtable_io::readTextValue(in, value)) break;
+        insert(key, value);
+    }
+    in.close();
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+void BasicHashTable<K, V, Hash, Eq, Probing, Policy>::writeToFile(const std::string& filename) {
+    std::ofstream out(filename);
+    forEachEntry([&](const K& key, const V& value) {
+        hashtable_io::writeText(out, key);
+        out << " ";
+        hashtable_io::writeText(out, value);
+        out << std::endl;
+    });
+    out.close();
+}
+
+// Формат: int size, int capacity, затем size записей (ключ, значение)
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::serializeToBinary(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    int savedSize = static_cast<int>(size);
+    int savedCapacity = static_cast<int>(table.capacity);
+    out.write(reinterpret_cast<const char*>(&savedSize), sizeof(savedSize));
+    out.write(reinterpret_cast<const char*>(&savedCapacity), sizeof(savedCapacity));
+
+    forEachEntry([&](const K& key, const V& value) {
+        hashtable_io::writeBinary(out, key);
+        hashtable_io::writeBinary(out, value);
+    });
+
+    out.close();
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::deserializeFromBinary(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    int savedSize, savedCapacity;
+    in.read(reinterpret_cast<char*>(&savedSize), sizeof(savedSize));
+    in.read(reinterpret_cast<char*>(&savedCapacity), sizeof(savedCapacity));
+    if (!in || savedSize < 0 || savedCapacity < 2 || savedSize > savedCapacity) return false;
+
+    // Ёмкость из файла, но не меньше нужной для savedSize при kMaxLoad:
+    // повреждённая пара size/capacity не должна заполнить таблицу целиком
+    size_t capacity = std::max(roundCapacity(static_cast<size_t>(savedCapacity)), capacityFor(savedSize));
+    release(old);
+    release(table);
+    table = allocate(capacity);
+    size = 0;
+    oldSize = 0;
+    migrated = 0;
+    tombstones = 0;
+
+    for (int n = 0; n < savedSize; ++n) {
+        K key;
+        V value;
+        if (!hashtable_io::readBinary(in, key) || !hashtable_io::readBinary(in, value)) break;
+
+        // Размещаем без рехэша: ёмкость рассчитана на savedSize
+        if (!place(std::move(key), std::move(value))) break;
+    }
+
+    in.close();
+    return true;
+}
+
+template <typename K, typename V, typename Hash, typename Eq, typename Probing, typename Policy>
+bool BasicHashTable<K, V, Hash, Eq, Probing, Policy>::writeSnapshot(const std::string& filename) const {
+    static_assert(std::is_trivially_copyable_v<K>, "snapshot needs a trivially copyable key");
+    namespace snap = hashtable_snapshot;
+
+    // Во время постепенного рехэша элементы в двух массивах — пишем уплотнённую копию
+    if (isMigrating()) {
+        BasicHashTable copy(table.capacity);
+        forEachEntry([&](const K& key, const V& value) { copy.insert(key, value); });
+        return copy.writeSnapshot(filename);
+    }
+
+    const size_t cap = table.capacity;
+    std::vector<uint64_t> offsets(cap + 1);
+    uint64_t total = 0;
+    for (size_t i = 0; i < cap; ++i) {
+        offsets[i] = total;
+        if (isFullSlot(table.ctrl[i])) total += snap::bytesOf(table.values[i]).size();
+    }
+    offsets[cap] = total;
+
+    snap::Header header{};
+    std::memcpy(header.magic, snap::kMagic, sizeof(header.magic));
+    header.keySize = sizeof(K);
+    header.groupWidth = kGrouped ? static_cast<uint32_t>(ControlGroup::kWidth) : 0;
+    header.policyId = Policy::kId;
+    header.probing = kGrouped ? 1 : kRobinHood ? 2 : 0;
+    header.capacity = cap;
+    header.size = size;
+    header.ctrlOffset = snap::align64(sizeof(header));
+    header.keysOffset = snap::align64(header.ctrlOffset + cap);
+    header.offsetsOffset = snap::align64(header.keysOffset + cap * sizeof(K));
+    header.bytesOffset = snap::align64(header.offsetsOffset + (cap + 1) * sizeof(uint64_t));
+    header.fileSize = header.bytesOffset + total;
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    auto padTo = [&](uint64_t offset) {
+        static const char zeros[64] = {};
+        uint64_t pos = static_cast<uint64_t>(out.tellp());
+        if (offset > pos) out.write(zeros, offset - pos);
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(header.ctrlOffset);
+    out.write(reinterpret_cast<const char*>(table.ctrl), cap);
+    padTo(header.keysOffset);
+    // Ключи пустых слотов — нули: по ним не сравнивают, пока тег не совпал
+    const K zeroKey{};
+    for (size_t i = 0; i < cap; ++i) {
+        const K& key = isFullSlot(table.ctrl[i]) ? table.keys[i] : zeroKey;
+        out.write(reinterpret_cast<const char*>(&key), sizeof(K));
+    }
+    padTo(header.offsetsOffset);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    padTo(header.bytesOffset);
+    for (size_t i = 0; i < cap; ++i) {
+        if (!isFullSlot(table.ctrl[i])) continue;
+        std::string_view b = snap::bytesOf(table.values[i]);
+        out.write(b.data(), b.size());
+    }
+
+    out.close();
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "HashTable.h"
+
+// Только чтение снимка BasicHashTable::writeSnapshot прямо из отображённых
+// страниц: open() проверяет заголовок и делает mmap, поиск идёт по тем же
+// массивам ctrl/keys тем же пробированием, что и в таблице. Время открытия
+// не зависит от числа элементов, страницы кэша общие для всех процессов.
+// Параметры шаблона должны совпадать с таблицей, записавшей снимок.
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          typename Probing = DefaultProbing, typename Policy = PrimeModPolicy>
+class BasicHashTableView {
+private:
+    using Table = BasicHashTable<K, V, Hash, Eq, Probing, Policy>;
+    using Slots = typename Table::Slots;
+
+    void* base;
+    size_t mappedSize;
+    Slots slots; // ctrl и keys указывают в отображение, values не используется
+    const uint64_t* offsets;
+    const char* bytes;
+    uint64_t bytesLength; // длина секции значений
+    size_t size;
+    Hash hasher;
+    Eq equal;
+
+    // Ёмкость, которую могла выделить таблица с этими Probing и Policy
+    static bool validCapacity(uint64_t cap) {
+        if constexpr (Table::kGrouped) {
+            uint64_t groups = cap / ControlGroup::kWidth;
+            return cap % ControlGroup::kWidth == 0 && (groups & (groups - 1)) == 0;
+        } else {
+            return Policy::roundCapacity(cap) == cap;
+        }
+    }
+
+    size_t slotOf(const K& key) const {
+        if (base == nullptr) return 0;
+        return Table::probe(slots, key, hasher(key), equal);
+    }
+
+public:
+    BasicHashTableView() : base(nullptr), mappedSize(0), offsets(nullptr), bytes(nullptr), bytesLength(0), size(0) {}
+    explicit BasicHashTableView(const std::string& filename) : BasicHashTableView() { open(filename); }
+    ~BasicHashTableView() { close(); }
+
+    BasicHashTableView(const BasicHashTableView&) = delete;
+    BasicHashTableView& operator=(const BasicHashTableView&) = delete;
+
+    // false — файла нет, он повреждён или записан с другими K/Probing/Policy.
+    // Проверяется только заголовок (время открытия не зависит от размера):
+    // секции идут по порядку и лежат в файле, ёмкость допустима для
+    // движка. Смещения значений проверяет findBytes при каждом чтении.
+    bool open(const std::string& filename) {
+        namespace snap = hashtable_snapshot;
+        close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(snap::Header)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        const auto* header = static_cast<const snap::Header*>(p);
+        const uint32_t groupWidth = Table::kGrouped ? static_cast<uint32_t>(ControlGroup::kWidth) : 0;
+        const uint64_t cap = header->capacity;
+        const uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+        // Секция [from, from + length) заканчивается не позже начала следующей
+        auto fits = [](uint64_t from, uint64_t length, uint64_t next) { return from <= next && length <= next - from; };
+        bool valid = std::memcmp(header->magic, snap::kMagic, sizeof(header->magic)) == 0 &&
+                     header->keySize == sizeof(K) && header->groupWidth == groupWidth &&
+                     header->policyId == Policy::kId &&
+                     header->probing == (Table::kGrouped ? 1u : Table::kRobinHood ? 2u : 0u) &&
+                     header->fileSize == fileSize &&
+                     // Ключи всех слотов лежат в файле — произведения ниже не переполняются
+                     cap > 0 && cap <= fileSize / sizeof(K) && validCapacity(cap) && header->size <= cap &&
+                     header->ctrlOffset >= sizeof(snap::Header) && fits(header->ctrlOffset, cap, header->keysOffset) &&
+                     header->keysOffset % alignof(K) == 0 &&
+                     fits(header->keysOffset, cap * sizeof(K), header->offsetsOffset) &&
+                     header->offsetsOffset % alignof(uint64_t) == 0 &&
+                     fits(header->offsetsOffset, (cap + 1) * sizeof(uint64_t), header->bytesOffset) &&
+                     header->bytesOffset <= fileSize;
+        if (!valid) {
+            munmap(p, st.st_size);
+            return false;
+        }
+
+        const char* data = static_cast<const char*>(p);
+        base = p;
+        mappedSize = st.st_size;
+        slots.ctrl = const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(data + header->ctrlOffset));
+        slots.keys = const_cast<K*>(reinterpret_cast<const K*>(data + header->keysOffset));
+        slots.values = nullptr;
+        slots.capacity = header->capacity;
+        offsets = reinterpret_cast<const uint64_t*>(data + header->offsetsOffset);
+        bytes = data + header->bytesOffset;
+        bytesLength = fileSize - header->bytesOffset;
+        size = header->size;
+        return true;
+    }
+
+    void close() {
+        if (base != nullptr) munmap(base, mappedSize);
+        base = nullptr;
+        mappedSize = 0;
+        slots = Slots();
+        offsets = nullptr;
+        bytes = nullptr;
+        bytesLength = 0;
+        size = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Байты значения в отображении (для std::string — сама строка).
+    // false и для ключа, чьи смещения выходят за секцию значений (файл испорчен).
+    bool findBytes(const K& key, std::string_view& out) const {
+        size_t i = slotOf(key);
+        if (i == slots.capacity) return false;
+        uint64_t from = offsets[i], to = offsets[i + 1];
+        if (from > to || to > bytesLength) return false;
+        out = std::string_view(bytes + from, to - from);
+        return true;
+    }
+
+    bool contains(const K& key) const { return slotOf(key) != slots.capacity; }
+
+    // Копия значения; для отсутствующего ключа — V()
+    V search(const K& key) const {
+        std::string_view b;
+        if (!findBytes(key, b)) return V();
+        if constexpr (!std::is_same_v<V, std::string>) {
+            if (b.size() != sizeof(V)) return V();
+        }
+        return hashtable_snapshot::valueFromBytes<V>(b);
+    }
+
+    size_t getSize() const { return size; }
+    bool isEmpty() const { return size == 0; }
+    size_t getCapacity() const { return slots.capacity; }
+};
+
+using HashTableView = BasicHashTableView<int, std::string>;
@@ -0,0 +1,122 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "HashTable.h"
+
+// Потокобезопасная таблица: ключи раскладываются по старшим битам хэша
+// в N независимых BasicHashTable. У каждого шарда свой reader-writer lock
+// и свой рехэш, поэтому потоки, работающие с разными шардами, не мешают
+// друг другу, а поиски в одном шарде идут параллельно.
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          typename Probing = DefaultProbing, typename Policy = PrimeModPolicy>
+class BasicShardedHashTable {
+public:
+    using Table = BasicHashTable<K, V, Hash, Eq, Probing, Policy>;
+
+private:
+    // Шард занимает свои кэш-линии, чтобы блокировки соседей не делили линию
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        Table table;
+
+        explicit Shard(size_t capacity) : table(capacity) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    unsigned shardBits;
+    Hash hasher;
+
+    // Старшие биты перемешанного хэша: младшие биты и тег ctrl
+    // (старшие биты другого произведения) внутри шарда остаются разными
+    Shard& shardFor(const K& key) const {
+        if (shardBits == 0) return *shards[0];
+        uint64_t h = Pow2MixPolicy::mix(hasher(key));
+        return *shards[static_cast<size_t>(h >> (64 - shardBits))];
+    }
+
+public:
+    // shardCount округляется вверх до степени двойки,
+    // initialCapacity делится между шардами
+    explicit BasicShardedHashTable(size_t shardCount = 16, size_t initialCapacity = 11) : shardBits(0) {
+        while ((size_t(1) << shardBits) < shardCount) ++shardBits;
+        size_t count = size_t(1) << shardBits;
+        size_t perShard = std::max<size_t>(initialCapacity / count, 11);
+        shards.reserve(count);
+        for (size_t i = 0; i < count; ++i) shards.push_back(std::make_unique<Shard>(perShard));
+    }
+
+    BasicShardedHashTable(const BasicShardedHashTable&) = delete;
+    BasicShardedHashTable& operator=(const BasicShardedHashTable&) = delete;
+
+    bool insert(const K& key, const V& value) {
+        Shard& s = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(s.lock);
+        return s.table.insert(key, value);
+    }
+
+    // Копия значения: указатель в шард после снятия блокировки небезопасен
+    V search(const K& key) const {
+        Shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+        return s.table.search(key);
+    }
+
+    // Копирует значение в out, если ключ есть
+    bool tryGet(const K& key, V& out) const {
+        Shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+        const V* value = s.table.find(key);
+        if (value == nullptr) return false;
+        out = *value;
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        Shard& s = shardFor(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+        return s.table.contains(key);
+    }
+
+    bool remove(const K& key) {
+        Shard& s = shardFor(key);
+        std::unique_lock<std::shared_mutex> guard(s.lock);
+        return s.table.remove(key);
+    }
+
+    // Сумма по шардам. При параллельных изменениях — значение на момент
+    // обхода каждого шарда, а не единый снимок.
+    size_t getSize() const {
+        size_t total = 0;
+        for (const auto& s : shards) {
+            std::shared_lock<std::shared_mutex> guard(s->lock);
+            total += s->table.getSize();
+        }
+        return total;
+    }
+    bool isEmpty() const { return getSize() == 0; }
+
+    size_t getShardCount() const { return shards.size(); }
+    size_t getShardSize(size_t i) const {
+        std::shared_lock<std::shared_mutex> guard(shards[i]->lock);
+        return shards[i]->table.getSize();
+    }
+
+    // Постепенный рехэш во всех шардах (см. BasicHashTable::setIncrementalRehash)
+    void setIncrementalRehash(size_t slotsPerOp) {
+        for (auto& s : shards) {
+            std::unique_lock<std::shared_mutex> guard(s->lock);
+            s->table.setIncrementalRehash(slotsPerOp);
+        }
+    }
+
+    void clear() {
+        for (auto& s : shards) {
+            std::unique_lock<std::shared_mutex> guard(s->lock);
+            s->table.clear();
+        }
+    }
+};
+
+using ShardedHashTable = BasicShardedHashTable<int, std::string>;
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Быстрый разбор текстового файла «ключ значение» для readFromFile.
+// Файл отображается через mmap, делится на куски по границам строк, куски
+// разбираются параллельно std::from_chars без iostream и локалей.
+// Правила те же, что у потокового чтения: ключ — после любых пробельных
+// символов (допускается знак '+'), значение — остаток строки без одного
+// ведущего пробела, на первой неразбираемой строке чтение останавливается.
+namespace hashtable_io {
+
+// Ключ — целое число; значение — строка или число
+template <typename K, typename V>
+constexpr bool kFastText = std::is_integral_v<K> && (std::is_same_v<V, std::string> || std::is_integral_v<V>);
+
+// Кусок меньше этого не отдаётся отдельному потоку
+constexpr size_t kMinTextChunk = 1 << 20;
+
+inline bool isTextSpace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+// Разбор числа как у operator>>: from_chars не принимает ведущий '+'
+template <typename T>
+std::from_chars_result parseNumber(const char* p, const char* end, T& out) {
+    if (end - p > 1 && *p == '+' && p[1] != '-') ++p;
+    return std::from_chars(p, end, out);
+}
+
+template <typename K, typename V>
+struct TextChunk {
+    std::vector<std::pair<K, V>> pairs;
+    bool stopped = false; // встретилась неразбираемая строка
+};
+
+template <typename K, typename V>
+void parseTextChunk(const char* p, const char* end, TextChunk<K, V>& out) {
+    for (;;) {
+        while (p < end && isTextSpace(*p)) ++p;
+        if (p == end) return;
+
+        K key;
+        auto [next, ec] = parseNumber(p, end, key);
+        if (ec != std::errc()) {
+            out.stopped = true;
+            return;
+        }
+        const char* eol = std::find(next, end, '\n');
+        const char* value = next < eol && *next == ' ' ? next + 1 : next;
+
+        if constexpr (std::is_same_v<V, std::string>) {
+            out.pairs.emplace_back(key, std::string(value, eol));
+        } else {
+            while (value < eol && isTextSpace(*value)) ++value;
+            V v{};
+            if (parseNumber(value, eol, v).ec != std::errc()) {
+                out.stopped = true;
+                return;
+            }
+            out.pairs.emplace_back(key, v);
+        }
+        p = eol == end ? end : eol + 1;
+    }
+}
+
+// Разбирает файл в chunks (по порядку файла). threads == 0 — по числу ядер.
+// false — файл не удалось открыть или отобразить. Исключение разбора
+// (bad_alloc) из любого потока пробрасывается вызывающему после join.
+template <typename K, typename V>
+bool parseMappedText(const std::string& filename, std::vector<TextChunk<K, V>>& chunks, unsigned threads = 0) {
+    chunks.clear();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t length = static_cast<size_t>(st.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(mapped);
+    const char* end = data + length;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::min<size_t>(threads, length / kMinTextChunk + 1);
+
+    // Границы кусков сдвигаются на начало следующей строки
+    std::vector<const char*> bounds(count + 1, end);
+    bounds[0] = data;
+    for (size_t i = 1; i < count; ++i) {
+        const char* p = std::max(data + length / count * i, bounds[i - 1]);
+        p = std::find(p, end, '\n');
+        bounds[i] = p == end ? end : p + 1;
+    }
+
+    chunks.resize(count);
+    std::vector<std::exception_ptr> errors(count);
+    auto parse = [&](size_t i) {
+        try {
+            parseTextChunk(bounds[i], bounds[i + 1], chunks[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (size_t i = 1; i < count; ++i) {
+        // Поток не создан — кусок разбирается здесь же
+        try {
+            workers.emplace_back(parse, i);
+        } catch (const std::system_error&) {
+            parse(i);
+        }
+    }
+    parse(0);
+    for (auto& w : workers) w.join();
+
+    munmap(mapped, length);
+    for (auto& e : errors) {
+        if (e) std::rethrow_exception(e);
+    }
+    return true;
+}
+
+} // namespace hashtable_io
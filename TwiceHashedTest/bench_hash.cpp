@@ -4,9 +4,17 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/chrono.hpp>
 #include "HashTable.h"
+#include "ShardedHashTable.h"
+#include "ConcurrentHashTable.h"
+#include "HashTableView.h"
+#include "CompactHashTable.h"
 #include <random>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
 
 BOOST_AUTO_TEST_CASE(benchmark_insert_random) {
     HashTable ht;
@@ -101,4 +109,435 @@ BOOST_AUTO_TEST_CASE(benchmark_mixed) {
     std::cout << "[BENCH] Mixed operations (" << OPS << " ops): " << dur.count() << " ms\n";
     std::cout << "       Final size: " << ht.getSize() << "\n";
 }
+
+template <typename Table>
+void benchProbing(const char* name, const std::vector<int>& keys, const std::vector<int>& misses) {
+    Table ht;
+
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int k : keys) ht.insert(k, "val");
+    auto mid = boost::chrono::high_resolution_clock::now();
+
+    size_t hits = 0;
+    for (int k : keys) hits += !ht.search(k).empty();
+    auto mid2 = boost::chrono::high_resolution_clock::now();
+
+    size_t found = 0;
+    for (int k : misses) found += !ht.search(k).empty();
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto us = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    auto probes = ht.probeStats();
+    std::cout << "[BENCH] " << name << ": insert " << us(start, mid) << " ms, hit "
+              << us(mid, mid2) << " ms, miss " << us(mid2, end) << " ms"
+              << " (hits " << hits << ", false " << found << "), probe length mean "
+              << probes.mean << " max " << probes.max << "\n";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_probing_engines) {
+    const int SIZE = 200000;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(1, 1 << 30);
+
+    std::vector<int> keys(SIZE), misses(SIZE);
+    for (int i = 0; i < SIZE; ++i) keys[i] = dis(gen);
+    for (int i = 0; i < SIZE; ++i) misses[i] = -dis(gen);
+
+    benchProbing<BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, DoubleHashProbing>>(
+        "Double hashing", keys, misses);
+    benchProbing<BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, GroupProbing>>(
+        "Group probing ", keys, misses);
+    benchProbing<BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, RobinHoodProbing>>(
+        "Robin Hood    ", keys, misses);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_insert_tail_latency) {
+    const int OPS = 2000000;
+
+    for (size_t step : {size_t(0), size_t(64)}) {
+        HashTable ht;
+        ht.setIncrementalRehash(step);
+
+        std::vector<double> lat(OPS);
+        for (int i = 0; i < OPS; ++i) {
+            auto t0 = boost::chrono::high_resolution_clock::now();
+            ht.insert(i * 7, "val");
+            auto t1 = boost::chrono::high_resolution_clock::now();
+            lat[i] = boost::chrono::duration_cast<boost::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
+        }
+        std::sort(lat.begin(), lat.end());
+
+        std::cout << "[BENCH] Insert latency, " << (step ? "incremental rehash" : "full rehash")
+                  << " (" << OPS << " ops): p50 " << lat[OPS / 2] << " us, p99.9 "
+                  << lat[OPS - OPS / 1000] << " us, max " << lat.back() << " us\n";
+    }
+}
+
+template <typename Table>
+void benchSequential(const char* name, int count, int stride) {
+    Table ht;
+
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; ++i) ht.insert(i * stride, "val");
+    auto mid = boost::chrono::high_resolution_clock::now();
+
+    size_t hits = 0;
+    for (int i = 0; i < count; ++i) hits += !ht.search(i * stride).empty();
+    for (int i = 0; i < count; ++i) hits += !ht.search(i * stride + 1).empty();
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    std::cout << "[BENCH] " << name << " stride " << stride << ": insert " << ms(start, mid)
+              << " ms, search hit+miss " << ms(mid, end) << " ms (hits " << hits << ")\n";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_sequential_keys) {
+    const int COUNT = 200000;
+    using PrimeTable = BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>,
+                                      DoubleHashProbing, PrimeModPolicy>;
+    using Pow2Table = BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>,
+                                     DoubleHashProbing, Pow2MixPolicy>;
+
+    for (int stride : {1, 64, 1024}) {
+        benchSequential<PrimeTable>("Prime/mod ", COUNT, stride);
+        benchSequential<Pow2Table>("Pow2/mix  ", COUNT, stride);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_find_vs_search) {
+    const int SIZE = 100000;
+    HashTable ht;
+    for (int i = 0; i < SIZE; ++i) ht.insert(i, std::string(100, 'v'));
+
+    size_t total = 0;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SIZE; ++i) total += ht.search(i).size();
+    auto mid = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SIZE; ++i) {
+        const std::string* v = ht.find(i);
+        total += v ? v->size() : 0;
+    }
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    std::cout << "[BENCH] 100-byte values (" << SIZE << " hits): search() copy " << ms(start, mid)
+              << " ms, find() " << ms(mid, end) << " ms (" << total << ")\n";
+}
+
+// Таблица заметно больше кэша, ключи пачки разбросаны случайно
+BOOST_AUTO_TEST_CASE(benchmark_search_batch) {
+    const int SIZE = 2000000;
+    const size_t LOOKUPS = 2000000;
+    HashTable ht;
+    for (int i = 0; i < SIZE; ++i) ht.insert(i, "val");
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dis(0, 2 * SIZE);
+    std::vector<int> keys(LOOKUPS);
+    for (auto& k : keys) k = dis(gen);
+    std::vector<const std::string*> out(LOOKUPS);
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+
+    size_t hits = 0;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (size_t j = 0; j < LOOKUPS; ++j) hits += ht.find(keys[j]) != nullptr;
+    auto end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] find() one by one (" << LOOKUPS << " lookups): " << ms(start, end)
+              << " ms, hits " << hits << "\n";
+
+    for (size_t batch : {1, 16, 64, 256, 1024}) {
+        hits = 0;
+        start = boost::chrono::high_resolution_clock::now();
+        for (size_t j = 0; j < LOOKUPS; j += batch) {
+            size_t n = std::min(batch, LOOKUPS - j);
+            hits += ht.searchBatch(keys.data() + j, n, out.data() + j);
+        }
+        end = boost::chrono::high_resolution_clock::now();
+        std::cout << "[BENCH] searchBatch batch " << batch << ": " << ms(start, end)
+                  << " ms, hits " << hits << "\n";
+    }
+}
+
+// Одна таблица под общим мьютексом — то, что заменяет ShardedHashTable
+class LockedHashTable {
+private:
+    mutable std::mutex lock;
+    HashTable table;
+
+public:
+    bool insert(int key, const std::string& value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.insert(key, value);
+    }
+    bool contains(int key) const {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.contains(key);
+    }
+    bool remove(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return table.remove(key);
+    }
+};
+
+// Пропускная способность (млн операций/с) при readPercent% поисков,
+// остальное поровну вставки и удаления
+template <typename Table>
+double benchThroughput(Table& ht, int threads, int readPercent, int opsPerThread) {
+    const int KEYS = 200000;
+    std::vector<std::thread> workers;
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&ht, t, readPercent, opsPerThread] {
+            std::mt19937 gen(100 + t);
+            std::uniform_int_distribution<> key_dis(0, KEYS - 1);
+            std::uniform_int_distribution<> op_dis(0, 99);
+            size_t hits = 0;
+            for (int i = 0; i < opsPerThread; ++i) {
+                int key = key_dis(gen);
+                int op = op_dis(gen);
+                if (op < readPercent) hits += ht.contains(key);
+                else if (op % 2 == 0) ht.insert(key, "val");
+                else ht.remove(key);
+            }
+            static std::atomic<size_t> sink;
+            sink += hits;
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = boost::chrono::high_resolution_clock::now();
+    double sec = boost::chrono::duration_cast<boost::chrono::microseconds>(end - start).count() / 1e6;
+    return threads * static_cast<double>(opsPerThread) / sec / 1e6;
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_sharded_threads) {
+    const int OPS = 500000;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "[BENCH] Threads scaling (" << OPS << " ops/thread, " << hw << " hw threads)\n";
+
+    for (int readPercent : {95, 50}) {
+        for (int threads = 1; threads <= static_cast<int>(std::max(4u, 2 * hw)) && threads <= 32; threads *= 2) {
+            LockedHashTable locked;
+            ShardedHashTable sharded(64);
+            for (int i = 0; i < 100000; ++i) {
+                locked.insert(i * 2, "val");
+                sharded.insert(i * 2, "val");
+            }
+            double a = benchThroughput(locked, threads, readPercent, OPS);
+            double b = benchThroughput(sharded, threads, readPercent, OPS);
+            std::cout << "[BENCH] " << readPercent << "% reads, " << threads << " threads: one mutex "
+                      << a << " Mops/s, 64 shards " << b << " Mops/s\n";
+        }
+    }
+}
+
+// 99% чтений: разделяемая блокировка шарда против чтения без блокировок
+BOOST_AUTO_TEST_CASE(benchmark_lock_free_reads) {
+    const int OPS = 1000000;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    ShardedHashTable sharded(64);
+    ConcurrentHashTable lockFree;
+    for (int i = 0; i < 100000; ++i) {
+        sharded.insert(i * 2, "val");
+        lockFree.insert(i * 2, "val");
+    }
+    for (int threads = 1; threads <= static_cast<int>(std::max(4u, 2 * hw)) && threads <= 32; threads *= 2) {
+        double a = benchThroughput(sharded, threads, 99, OPS);
+        double b = benchThroughput(lockFree, threads, 99, OPS);
+        std::cout << "[BENCH] 99% reads, " << threads << " threads: sharded " << a
+                  << " Mops/s, lock-free readers " << b << " Mops/s\n";
+    }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_snapshot_open) {
+    const int SIZE = 1000000;
+    const std::string binfile = "bench_snapshot.bin";
+    const std::string snapfile = "bench_snapshot.snap";
+    {
+        HashTable ht;
+        for (int i = 0; i < SIZE; ++i) ht.insert(i, "value " + std::to_string(i));
+        ht.serializeToBinary(binfile);
+        ht.writeSnapshot(snapfile);
+    }
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+
+    auto start = boost::chrono::high_resolution_clock::now();
+    HashTable loaded;
+    loaded.deserializeFromBinary(binfile);
+    auto mid = boost::chrono::high_resolution_clock::now();
+    HashTableView view(snapfile);
+    auto end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] Load " << SIZE << " entries: deserializeFromBinary " << ms(start, mid)
+              << " ms, HashTableView::open " << ms(mid, end) << " ms\n";
+
+    size_t total = 0;
+    start = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SIZE; ++i) total += loaded.find(i)->size();
+    mid = boost::chrono::high_resolution_clock::now();
+    for (int i = 0; i < SIZE; ++i) {
+        std::string_view b;
+        view.findBytes(i, b);
+        total += b.size();
+    }
+    end = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] " << SIZE << " lookups: table " << ms(start, mid) << " ms, view " << ms(mid, end)
+              << " ms (" << total << ")\n";
+
+    std::remove(binfile.c_str());
+    std::remove(snapfile.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_bulk_build) {
+    const int SIZE = 2000000;
+    std::vector<int> keys(SIZE);
+    std::vector<std::string> values(SIZE, "val");
+    for (int i = 0; i < SIZE; ++i) keys[i] = i * 7;
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::microseconds>(b - a).count() / 1000.0;
+    };
+
+    auto t0 = boost::chrono::high_resolution_clock::now();
+    {
+        HashTable ht;
+        for (int i = 0; i < SIZE; ++i) ht.insert(keys[i], values[i]);
+    }
+    auto t1 = boost::chrono::high_resolution_clock::now();
+    {
+        HashTable ht;
+        ht.reserve(SIZE);
+        for (int i = 0; i < SIZE; ++i) ht.insert(keys[i], values[i]);
+    }
+    auto t2 = boost::chrono::high_resolution_clock::now();
+    {
+        HashTable ht;
+        ht.bulkBuild(keys.data(), values.data(), SIZE);
+    }
+    auto t3 = boost::chrono::high_resolution_clock::now();
+    std::cout << "[BENCH] Build " << SIZE << " entries: insert from default capacity " << ms(t0, t1)
+              << " ms, reserve + insert " << ms(t1, t2) << " ms, bulkBuild " << ms(t2, t3) << " ms\n";
+}
+
+// Удаления и вставки вперемешку при постоянном размере
+template <typename Table>
+void benchChurn(const char* name, int size, int rounds) {
+    // Разбросанные ключи: у последовательных цепочки проб тривиальны
+    auto key = [](int n) { return static_cast<int>(static_cast<unsigned>(n) * 2654435761u); };
+    Table ht;
+    for (int i = 0; i < size; ++i) ht.insert(key(i), "val");
+
+    auto start = boost::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 0; i < size; i += 2) ht.remove(key(r * size + i));
+        for (int i = 0; i < size; i += 2) ht.insert(key((r + 1) * size + i), "val");
+    }
+    size_t hits = 0;
+    for (int i = 0; i < size; ++i) hits += ht.contains(key(rounds * size + i));
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    auto probes = ht.probeStats();
+    std::cout << "[BENCH] Churn " << name << ": " << boost::chrono::duration_cast<boost::chrono::milliseconds>(end - start).count()
+              << " ms, tombstones " << ht.getTombstoneCount() << ", probe length mean " << probes.mean << " max "
+              << probes.max << " (" << hits << ")\n";
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_delete_heavy) {
+    benchChurn<BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, DoubleHashProbing>>(
+        "double hashing", 100000, 20);
+    benchChurn<BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, RobinHoodProbing>>(
+        "Robin Hood    ", 100000, 20);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_memory_per_entry) {
+    const int SIZE = 1000000;
+    for (size_t length : {size_t(8), size_t(24), size_t(64)}) {
+        HashTable ht;
+        CompactHashTable compact;
+        std::string value(length, 'v');
+        for (int i = 0; i < SIZE; ++i) {
+            ht.insert(i, value);
+            compact.insert(i, value);
+        }
+        size_t found = 0;
+        auto start = boost::chrono::high_resolution_clock::now();
+        for (int i = 0; i < SIZE; ++i) found += ht.find(i)->size();
+        auto mid = boost::chrono::high_resolution_clock::now();
+        for (int i = 0; i < SIZE; ++i) {
+            std::string_view v;
+            compact.find(i, v);
+            found += v.size();
+        }
+        auto end = boost::chrono::high_resolution_clock::now();
+
+        std::cout << "[BENCH] " << length << "-byte values, bytes/entry: HashTable "
+                  << static_cast<double>(ht.memoryUsage()) / SIZE << ", CompactHashTable "
+                  << static_cast<double>(compact.memoryUsage()) / SIZE << "; lookups "
+                  << boost::chrono::duration_cast<boost::chrono::milliseconds>(mid - start).count() << " ms vs "
+                  << boost::chrono::duration_cast<boost::chrono::milliseconds>(end - mid).count() << " ms ("
+                  << found << ")\n";
+    }
+}
+
+// Соберите с -DHASHTABLE_STATS, чтобы увидеть счётчики и гистограммы проб
+BOOST_AUTO_TEST_CASE(benchmark_stats_report) {
+    const int SIZE = 200000;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> dis(0, 4 * SIZE);
+
+    HashTable ht;
+    for (int i = 0; i < SIZE; ++i) ht.insert(dis(gen), "val");
+    for (int i = 0; i < SIZE; ++i) ht.contains(dis(gen));
+    for (int i = 0; i < SIZE / 2; ++i) ht.remove(dis(gen));
+    for (int i = 0; i < SIZE; ++i) ht.contains(dis(gen));
+
+    std::cout << "[BENCH] HashTable stats" << (HashTable::kStatsEnabled ? "" : " (HASHTABLE_STATS off)") << ":\n";
+    ht.getStats().print(std::cout);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_text_load) {
+    const int SIZE = 2000000;
+    const std::string file = "bench_load.txt";
+    {
+        std::ofstream out(file);
+        for (int i = 0; i < SIZE; ++i) out << i * 3 << " value number " << i << "\n";
+    }
+
+    auto ms = [](auto a, auto b) {
+        return boost::chrono::duration_cast<boost::chrono::milliseconds>(b - a).count();
+    };
+
+    // Прежний способ: operator>>, getline и insert по строке
+    auto start = boost::chrono::high_resolution_clock::now();
+    {
+        HashTable ht;
+        std::ifstream in(file);
+        int key;
+        std::string value;
+        while (in >> key) {
+            std::getline(in, value);
+            if (!value.empty() && value[0] == ' ') value.erase(0, 1);
+            ht.insert(key, value);
+        }
+    }
+    auto mid = boost::chrono::high_resolution_clock::now();
+    HashTable ht;
+    ht.readFromFile(file);
+    auto end = boost::chrono::high_resolution_clock::now();
+
+    std::cout << "[BENCH] Text load " << SIZE << " lines: iostream + insert " << ms(start, mid)
+              << " ms, readFromFile (mmap, " << std::max(1u, std::thread::hardware_concurrency())
+              << " threads) " << ms(mid, end) << " ms, size " << ht.getSize() << "\n";
+    std::remove(file.c_str());
+}
 #endif
\ No newline at end of file
@@ -3,11 +3,24 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "HashTable.h"
+#include "ShardedHashTable.h"
+#include "ConcurrentHashTable.h"
+#include "HashTableView.h"
+#include "CompactHashTable.h"
 #include <fstream>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 #include <random>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <iterator>
+
+// Тесты, которые рассчитывают на ёмкость и надгробия двойного хэширования,
+// не зависят от выбора пробирования по умолчанию (HASHTABLE_GROUP_PROBING)
+using DoubleHashTable = BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, DoubleHashProbing>;
+using DoubleHashTableView = BasicHashTableView<int, std::string, std::hash<int>, std::equal_to<int>, DoubleHashProbing>;
 
 std::string captureOutput(std::function<void()> func) {
     std::ostringstream oss;
@@ -64,7 +77,7 @@ BOOST_AUTO_TEST_CASE(test_remove) {
 }
 
 BOOST_AUTO_TEST_CASE(test_rehash_on_load_factor) {
-    HashTable ht(5); // маленькая начальная ёмкость для быстрого рехэша
+    DoubleHashTable ht(5); // маленькая начальная ёмкость для быстрого рехэша
 
     // Заполняем до load factor > 0.7
     ht.insert(1, "a");
@@ -159,4 +172,864 @@ BOOST_AUTO_TEST_CASE(test_binary_empty_and_fail) {
     HashTable ht;
     BOOST_CHECK(!ht.serializeToBinary("/invalid/path/file.bin"));
 }
+
+BOOST_AUTO_TEST_CASE(test_template_instantiation) {
+    BasicHashTable<std::string, int> ht;
+    BOOST_CHECK(ht.insert("one", 1));
+    BOOST_CHECK(ht.insert("two", 2));
+    BOOST_CHECK(ht.insert("one", 11)); // обновление
+
+    BOOST_CHECK(ht.search("one") == 11);
+    BOOST_CHECK(ht.search("two") == 2);
+    BOOST_CHECK(ht.search("none") == 0);
+    BOOST_CHECK(ht.getSize() == 2);
+
+    BOOST_CHECK(ht.remove("one"));
+    BOOST_CHECK(ht.search("one") == 0);
+    BOOST_CHECK(ht.getSize() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_tombstone_reuse_no_duplicates) {
+    HashTable ht(11);
+    ht.insert(1, "a");
+    ht.insert(12, "b"); // та же начальная позиция, что и у 1
+    ht.remove(1);
+
+    // Ключ 12 стоит за надгробием — повторная вставка должна обновить его
+    ht.insert(12, "c");
+    BOOST_CHECK(ht.getSize() == 1);
+    BOOST_CHECK(ht.search(12) == "c");
+    BOOST_CHECK(ht.remove(12));
+    BOOST_CHECK(ht.search(12) == "");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_keys) {
+    HashTable ht;
+    for (int k = -50; k < 50; ++k) ht.insert(k, std::to_string(k));
+    BOOST_CHECK(ht.getSize() == 100);
+    for (int k = -50; k < 50; ++k) BOOST_CHECK(ht.search(k) == std::to_string(k));
+}
+
+using GroupHashTable = BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, GroupProbing>;
+
+BOOST_AUTO_TEST_CASE(test_group_probing_basic) {
+    GroupHashTable ht;
+    BOOST_CHECK(ht.getCapacity() % ControlGroup::kWidth == 0);
+
+    BOOST_CHECK(ht.insert(10, "ten"));
+    BOOST_CHECK(ht.insert(20, "twenty"));
+    BOOST_CHECK(ht.insert(10, "TEN"));
+    BOOST_CHECK(ht.search(10) == "TEN");
+    BOOST_CHECK(ht.search(20) == "twenty");
+    BOOST_CHECK(ht.search(30) == "");
+    BOOST_CHECK(ht.getSize() == 2);
+
+    BOOST_CHECK(ht.remove(10));
+    BOOST_CHECK(!ht.remove(10));
+    BOOST_CHECK(ht.search(10) == "");
+    BOOST_CHECK(ht.getSize() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_group_probing_random_ops) {
+    GroupHashTable ht;
+    HashTable ref;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> op_dis(0, 2);
+    std::uniform_int_distribution<> key_dis(-2000, 2000);
+
+    for (int i = 0; i < 20000; ++i) {
+        int key = key_dis(gen);
+        int op = op_dis(gen);
+        if (op == 0) {
+            ht.insert(key, std::to_string(i));
+            ref.insert(key, std::to_string(i));
+        } else if (op == 1) {
+            BOOST_REQUIRE(ht.search(key) == ref.search(key));
+        } else {
+            BOOST_REQUIRE(ht.remove(key) == ref.remove(key));
+        }
+    }
+    BOOST_CHECK(ht.getSize() == ref.getSize());
+}
+
+BOOST_AUTO_TEST_CASE(test_tombstone_count_and_purge) {
+    DoubleHashTable ht(101);
+    for (int k = 0; k < 60; ++k) ht.insert(k, "v" + std::to_string(k));
+    for (int k = 0; k < 30; ++k) ht.remove(k);
+
+    BOOST_CHECK(ht.getTombstoneCount() == 30);
+    BOOST_CHECK(ht.getOccupancy() > ht.getLoadFactor());
+
+    ht.purgeTombstones();
+    BOOST_CHECK(ht.getTombstoneCount() == 0);
+    BOOST_CHECK(ht.getCapacity() == 101);
+    BOOST_CHECK(ht.getSize() == 30);
+    for (int k = 0; k < 30; ++k) BOOST_CHECK(ht.search(k) == "");
+    for (int k = 30; k < 60; ++k) BOOST_CHECK(ht.search(k) == "v" + std::to_string(k));
+}
+
+BOOST_AUTO_TEST_CASE(test_group_purge) {
+    GroupHashTable ht(256);
+    for (int k = 0; k < 170; ++k) ht.insert(k * 7, std::to_string(k));
+    for (int k = 0; k < 170; k += 2) ht.remove(k * 7);
+
+    ht.purgeTombstones();
+    BOOST_CHECK(ht.getTombstoneCount() == 0);
+    for (int k = 0; k < 170; ++k) {
+        BOOST_CHECK(ht.search(k * 7) == (k % 2 ? std::to_string(k) : ""));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_churn_keeps_occupancy_bounded) {
+    HashTable ht;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> key_dis(1, 500);
+
+    for (int i = 0; i < 200000; ++i) {
+        int key = key_dis(gen);
+        if (i % 2) ht.insert(key, "x");
+        else ht.remove(key);
+        BOOST_REQUIRE(ht.getSize() + ht.getTombstoneCount() <= ht.getSlotCount() * HashTable::kMaxLoad + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_shrink_on_low_load) {
+    HashTable ht;
+    for (int k = 0; k < 1000; ++k) ht.insert(k, "v");
+    size_t grown = ht.getSlotCount();
+
+    for (int k = 0; k < 995; ++k) ht.remove(k);
+    BOOST_CHECK(ht.getSlotCount() < grown);
+    BOOST_CHECK(ht.getCapacity() >= 11);
+    for (int k = 995; k < 1000; ++k) BOOST_CHECK(ht.search(k) == "v");
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_rehash) {
+    HashTable ht;
+    HashTable ref;
+    ht.setIncrementalRehash(4);
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<> op_dis(0, 3);
+    std::uniform_int_distribution<> key_dis(0, 30000);
+
+    bool sawRehash = false;
+    for (int i = 0; i < 60000; ++i) {
+        int key = key_dis(gen);
+        int op = op_dis(gen);
+        if (op <= 1) {
+            ht.insert(key, std::to_string(i));
+            ref.insert(key, std::to_string(i));
+        } else if (op == 2) {
+            BOOST_REQUIRE(ht.search(key) == ref.search(key));
+        } else {
+            BOOST_REQUIRE(ht.remove(key) == ref.remove(key));
+        }
+        sawRehash = sawRehash || ht.isRehashing();
+        BOOST_REQUIRE(ht.getSize() == ref.getSize());
+    }
+    BOOST_CHECK(sawRehash);
+
+    ht.finishRehash();
+    BOOST_CHECK(!ht.isRehashing());
+    for (int k = 0; k <= 30000; ++k) BOOST_REQUIRE(ht.search(k) == ref.search(k));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_rehash_io) {
+    HashTable ht;
+    ht.setIncrementalRehash(2);
+    for (int k = 0; k < 100; ++k) ht.insert(k, "v" + std::to_string(k));
+
+    const std::string binfile = "hash_incremental.bin";
+    BOOST_CHECK(ht.serializeToBinary(binfile));
+
+    HashTable loaded;
+    BOOST_CHECK(loaded.deserializeFromBinary(binfile));
+    BOOST_CHECK(loaded.getSize() == 100);
+    for (int k = 0; k < 100; ++k) BOOST_CHECK(loaded.search(k) == "v" + std::to_string(k));
+
+    std::remove(binfile.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_pow2_mix_policy) {
+    BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, DoubleHashProbing, Pow2MixPolicy> ht;
+    BOOST_CHECK((ht.getCapacity() & (ht.getCapacity() - 1)) == 0);
+
+    for (int k = -5000; k < 5000; ++k) ht.insert(k * 64, std::to_string(k));
+    BOOST_CHECK(ht.getSize() == 10000);
+    BOOST_CHECK((ht.getCapacity() & (ht.getCapacity() - 1)) == 0);
+    for (int k = -5000; k < 5000; ++k) BOOST_REQUIRE(ht.search(k * 64) == std::to_string(k));
+
+    for (int k = -5000; k < 5000; k += 2) BOOST_REQUIRE(ht.remove(k * 64));
+    BOOST_CHECK(ht.getSize() == 5000);
+    BOOST_CHECK(ht.search(-5000 * 64) == "");
+    BOOST_CHECK(ht.search(-4999 * 64) == "-4999");
+}
+
+BOOST_AUTO_TEST_CASE(test_group_probing_pow2_policy) {
+    BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, GroupProbing, Pow2MixPolicy> ht;
+    for (int k = 0; k < 20000; ++k) ht.insert(k << 8, "v");
+    BOOST_CHECK(ht.getSize() == 20000);
+    for (int k = 0; k < 20000; ++k) BOOST_REQUIRE(ht.search(k << 8) == "v");
+    BOOST_CHECK(ht.search(1) == "");
+}
+
+BOOST_AUTO_TEST_CASE(test_find_and_contains) {
+    HashTable ht;
+    ht.insert(1, "one");
+    ht.insert(2, ""); // пустое значение теперь отличимо от отсутствия
+
+    BOOST_REQUIRE(ht.find(1) != nullptr);
+    BOOST_CHECK(*ht.find(1) == "one");
+    BOOST_CHECK(ht.contains(2));
+    BOOST_CHECK(ht.find(2)->empty());
+    BOOST_CHECK(!ht.contains(3));
+    BOOST_CHECK(ht.find(3) == nullptr);
+
+    *ht.find(1) += "!";
+    BOOST_CHECK(ht.search(1) == "one!");
+}
+
+BOOST_AUTO_TEST_CASE(test_try_emplace_and_insert_or_assign) {
+    HashTable ht;
+    auto r = ht.try_emplace(5, 3, 'x');
+    BOOST_CHECK(r.second);
+    BOOST_CHECK(*r.first == "xxx");
+
+    r = ht.try_emplace(5, "other");
+    BOOST_CHECK(!r.second);
+    BOOST_CHECK(*r.first == "xxx");
+
+    std::string big(100, 'a');
+    r = ht.insert_or_assign(5, std::move(big));
+    BOOST_CHECK(!r.second);
+    BOOST_CHECK(ht.search(5) == std::string(100, 'a'));
+
+    std::string fresh(50, 'b');
+    r = ht.insert_or_assign(6, std::move(fresh));
+    BOOST_CHECK(r.second);
+    BOOST_CHECK(ht.find(6)->size() == 50);
+    BOOST_CHECK(ht.getSize() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_heterogeneous_lookup) {
+    BasicHashTable<std::string, int, StringHash, StringEqual> ht;
+    ht.insert_or_assign(std::string("alpha"), 1);
+    ht.try_emplace("beta", 2);
+
+    std::string_view key = "alpha";
+    BOOST_REQUIRE(ht.find(key) != nullptr);
+    BOOST_CHECK(*ht.find(key) == 1);
+    BOOST_CHECK(ht.contains("beta"));
+    BOOST_CHECK(!ht.contains(std::string_view("gamma")));
+}
+
+BOOST_AUTO_TEST_CASE(test_search_batch) {
+    HashTable ht;
+    for (int i = 0; i < 500; ++i) ht.insert(i * 3, "v" + std::to_string(i));
+
+    // Больше одной порции kBatchChunk, половина ключей отсутствует
+    std::vector<int> keys;
+    for (int i = 0; i < 300; ++i) keys.push_back(i * 3 + (i % 2));
+    std::vector<const std::string*> out(keys.size());
+
+    size_t found = ht.searchBatch(keys.data(), keys.size(), out.data());
+    BOOST_CHECK_EQUAL(found, 150u);
+    for (size_t j = 0; j < keys.size(); ++j) {
+        BOOST_CHECK(out[j] == ht.find(keys[j]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_search_batch_during_rehash) {
+    GroupHashTable ht;
+    ht.setIncrementalRehash(4);
+    // Вставляем, пока не начнётся перенос: часть ключей остаётся в old
+    std::vector<int> keys;
+    for (int i = 0; i < 2000 && !(i > 100 && ht.isRehashing()); ++i) {
+        ht.insert(i, std::to_string(i));
+        keys.push_back(i);
+    }
+    BOOST_REQUIRE(ht.isRehashing());
+
+    std::vector<const std::string*> out(keys.size());
+    BOOST_CHECK_EQUAL(ht.searchBatch(keys.data(), keys.size(), out.data()), keys.size());
+    for (size_t j = 0; j < keys.size(); ++j) {
+        BOOST_REQUIRE(out[j] != nullptr);
+        BOOST_CHECK(*out[j] == std::to_string(keys[j]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_sharded_basic) {
+    ShardedHashTable ht(5);
+    BOOST_CHECK_EQUAL(ht.getShardCount(), 8u);
+    BOOST_CHECK(ht.isEmpty());
+
+    for (int i = 0; i < 1000; ++i) BOOST_CHECK(ht.insert(i, std::to_string(i)));
+    BOOST_CHECK(ht.insert(5, "dup")); // как HashTable: обновление значения
+    BOOST_CHECK_EQUAL(ht.getSize(), 1000u);
+    BOOST_CHECK(ht.search(5) == "dup");
+
+    std::string value;
+    BOOST_CHECK(ht.tryGet(42, value));
+    BOOST_CHECK(value == "42");
+    BOOST_CHECK(!ht.tryGet(5000, value));
+
+    // Ключи расходятся по всем шардам
+    for (size_t i = 0; i < ht.getShardCount(); ++i) BOOST_CHECK(ht.getShardSize(i) > 0);
+
+    BOOST_CHECK(ht.remove(42));
+    BOOST_CHECK(!ht.contains(42));
+    BOOST_CHECK_EQUAL(ht.getSize(), 999u);
+
+    ht.clear();
+    BOOST_CHECK(ht.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(test_sharded_concurrent) {
+    ShardedHashTable ht(8);
+    ht.setIncrementalRehash(16);
+    const int THREADS = 4;
+    const int PER_THREAD = 20000;
+
+    // Каждый поток пишет свой диапазон и читает чужие
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&ht, t] {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> dis(0, THREADS * PER_THREAD - 1);
+            for (int i = 0; i < PER_THREAD; ++i) {
+                int key = t * PER_THREAD + i;
+                ht.insert(key, std::to_string(key));
+                std::string seen = ht.search(dis(gen));
+                if (!seen.empty() && seen.size() > 6) std::abort();
+                if (i % 4 == 3) ht.remove(key - 1);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    BOOST_CHECK_EQUAL(ht.getSize(), static_cast<size_t>(THREADS * PER_THREAD * 3 / 4));
+    for (int key = 0; key < THREADS * PER_THREAD; ++key) {
+        bool removed = key % 4 == 2;
+        BOOST_REQUIRE(ht.contains(key) != removed);
+        if (!removed) BOOST_REQUIRE(ht.search(key) == std::to_string(key));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_table_basic) {
+    ConcurrentHashTable ht;
+    for (int i = 0; i < 1000; ++i) BOOST_CHECK(ht.insert(i, std::to_string(i)));
+    BOOST_CHECK_EQUAL(ht.getSize(), 1000u);
+    BOOST_CHECK(ht.getCapacity() > 1000u);
+
+    BOOST_CHECK(ht.insert(7, "seven"));
+    BOOST_CHECK(ht.search(7) == "seven");
+    BOOST_CHECK_EQUAL(ht.getSize(), 1000u);
+
+    for (int i = 0; i < 1000; i += 2) BOOST_CHECK(ht.remove(i));
+    BOOST_CHECK(!ht.remove(0));
+    BOOST_CHECK_EQUAL(ht.getSize(), 500u);
+    BOOST_CHECK(!ht.contains(10));
+    BOOST_CHECK(ht.search(10) == "");
+
+    std::string value;
+    BOOST_CHECK(ht.tryGet(11, value));
+    BOOST_CHECK(value == "11");
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_readers_with_writer) {
+    ConcurrentHashTable ht;
+    const int KEYS = 2000;
+    for (int i = 0; i < KEYS; ++i) ht.insert(i, std::to_string(i) + ":0");
+
+    // Читатели проверяют, что значение всегда принадлежит своему ключу,
+    // пока писатель заменяет, удаляет и вставляет (с рехэшами)
+    std::atomic<bool> stop(false);
+    std::atomic<int> bad(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> dis(0, 4 * KEYS);
+            while (!stop.load()) {
+                int key = dis(gen);
+                std::string v = ht.search(key);
+                std::string prefix = std::to_string(key) + ":";
+                if (!v.empty() && v.compare(0, prefix.size(), prefix) != 0) ++bad;
+            }
+        });
+    }
+
+    for (int round = 1; round <= 5; ++round) {
+        for (int i = 0; i < 4 * KEYS; ++i) {
+            if (i % 3 == 0) ht.remove(i);
+            else ht.insert(i, std::to_string(i) + ":" + std::to_string(round));
+        }
+    }
+    stop = true;
+    for (auto& r : readers) r.join();
+
+    BOOST_CHECK_EQUAL(bad.load(), 0);
+    for (int i = 0; i < 4 * KEYS; ++i) {
+        BOOST_REQUIRE(ht.contains(i) == (i % 3 != 0));
+    }
+
+    // Без активных читателей всё отложенное освобождается
+    while (EpochDomain::instance().collect() > 0) {
+    }
+    EpochDomain::instance().collect();
+    BOOST_CHECK_EQUAL(EpochDomain::instance().pendingCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_view) {
+    HashTable ht;
+    for (int i = 0; i < 3000; ++i) ht.insert(i * 7 - 1000, i % 5 == 0 ? "" : "value " + std::to_string(i));
+    for (int i = 0; i < 3000; i += 3) ht.remove(i * 7 - 1000); // надгробия тоже попадают в снимок
+
+    const std::string file = "snapshot_test.bin";
+    BOOST_REQUIRE(ht.writeSnapshot(file));
+
+    HashTableView view;
+    BOOST_REQUIRE(view.open(file));
+    BOOST_CHECK_EQUAL(view.getSize(), ht.getSize());
+    BOOST_CHECK_EQUAL(view.getCapacity(), ht.getSlotCount());
+    for (int k = -2000; k < 22000; ++k) {
+        BOOST_REQUIRE(view.contains(k) == ht.contains(k));
+        BOOST_REQUIRE(view.search(k) == ht.search(k));
+    }
+    std::string_view bytes;
+    BOOST_CHECK(view.findBytes(1 * 7 - 1000, bytes));
+    BOOST_CHECK(bytes == "value 1");
+
+    view.close();
+    BOOST_CHECK(!view.isOpen());
+    BOOST_CHECK(!view.contains(1 * 7 - 1000));
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_view_engines) {
+    const std::string file = "snapshot_engines.bin";
+
+    GroupHashTable grouped;
+    grouped.setIncrementalRehash(8); // снимок во время переноса
+    for (int i = 0; i < 5000; ++i) grouped.insert(i, std::to_string(i));
+    BOOST_REQUIRE(grouped.writeSnapshot(file));
+
+    BasicHashTableView<int, std::string, std::hash<int>, std::equal_to<int>, GroupProbing> view(file);
+    BOOST_REQUIRE(view.isOpen());
+    BOOST_CHECK_EQUAL(view.getSize(), 5000u);
+    for (int i = 0; i < 5000; ++i) BOOST_REQUIRE(view.search(i) == std::to_string(i));
+    BOOST_CHECK(!view.contains(5000));
+
+    // Снимок другой таблицы не откроется как представление двойного хэширования
+    DoubleHashTableView mismatched;
+    BOOST_CHECK(!mismatched.open(file));
+    BOOST_CHECK(!mismatched.open("no_such_snapshot.bin"));
+
+    BasicHashTable<int, double, std::hash<int>, std::equal_to<int>, DoubleHashProbing, Pow2MixPolicy> numbers;
+    for (int i = 0; i < 100; ++i) numbers.insert(i, i * 0.5);
+    BOOST_REQUIRE(numbers.writeSnapshot(file));
+    BasicHashTableView<int, double, std::hash<int>, std::equal_to<int>, DoubleHashProbing, Pow2MixPolicy> nview(file);
+    BOOST_REQUIRE(nview.isOpen());
+    BOOST_CHECK_EQUAL(nview.search(42), 21.0);
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_snapshot_view_rejects_damage) {
+    namespace snap = hashtable_snapshot;
+    HashTable ht;
+    for (int i = 0; i < 1000; ++i) ht.insert(i, "value " + std::to_string(i));
+    const std::string file = "snapshot_damaged.bin";
+    BOOST_REQUIRE(ht.writeSnapshot(file));
+
+    std::string bytes;
+    {
+        std::ifstream in(file, std::ios::binary);
+        bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    snap::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    auto withHeader = [&](snap::Header h) {
+        std::string damaged = bytes;
+        std::memcpy(&damaged[0], &h, sizeof(h));
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(damaged.data(), damaged.size());
+    };
+
+    // Каждое поле по отдельности: порядок секций, выход за файл, ёмкость
+    std::vector<snap::Header> damaged(9, header);
+    damaged[0].ctrlOffset = 0;
+    damaged[1].ctrlOffset = header.fileSize;
+    damaged[2].keysOffset = header.ctrlOffset + 1;
+    damaged[3].keysOffset = header.keysOffset + 1;
+    damaged[4].offsetsOffset = header.fileSize + 64;
+    damaged[5].bytesOffset = header.offsetsOffset;
+    damaged[6].capacity = header.capacity + 1; // не простое число
+    damaged[7].capacity = uint64_t(1) << 62;
+    damaged[8].size = header.capacity + 1;
+    for (const snap::Header& h : damaged) {
+        withHeader(h);
+        HashTableView view;
+        BOOST_CHECK(!view.open(file));
+        BOOST_CHECK(!view.isOpen());
+    }
+
+    // Обрезанный файл с прежним fileSize в заголовке
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), header.offsetsOffset);
+    }
+    HashTableView truncated;
+    BOOST_CHECK(!truncated.open(file));
+
+    // Испорченная таблица смещений: ключ не читается за пределами секции
+    std::string corrupt = bytes;
+    uint64_t huge = header.fileSize * 4;
+    for (size_t i = 0; i <= header.capacity; ++i) {
+        std::memcpy(&corrupt[header.offsetsOffset + i * sizeof(uint64_t)], &huge, sizeof(huge));
+    }
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), corrupt.size());
+    }
+    HashTableView view;
+    BOOST_REQUIRE(view.open(file));
+    std::string_view value;
+    BOOST_CHECK(view.contains(5));
+    BOOST_CHECK(!view.findBytes(5, value));
+    BOOST_CHECK(view.search(5).empty());
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_reserve) {
+    HashTable ht;
+    ht.reserve(10000);
+    size_t reserved = ht.getSlotCount();
+    BOOST_CHECK(reserved * HashTable::kMaxLoad > 10000);
+
+    for (int i = 0; i < 10000; ++i) ht.insert(i, "v");
+    BOOST_CHECK_EQUAL(ht.getSlotCount(), reserved);
+
+    // Резерв не снимается удалениями
+    for (int i = 0; i < 10000; ++i) ht.remove(i);
+    BOOST_CHECK_EQUAL(ht.getSlotCount(), reserved);
+
+    // Меньший резерв ничего не меняет
+    ht.reserve(10);
+    BOOST_CHECK_EQUAL(ht.getSlotCount(), reserved);
+
+    // clear() оставляет массивы, но снимает резерв: удаления снова сжимают
+    ht.insert(1, "v");
+    ht.clear();
+    BOOST_CHECK_EQUAL(ht.getSlotCount(), reserved);
+    ht.insert(1, "v");
+    ht.insert(2, "v");
+    ht.remove(1);
+    BOOST_CHECK(ht.getSlotCount() < reserved);
+    BOOST_CHECK(ht.getCapacity() >= 11);
+    BOOST_CHECK(ht.search(2) == "v");
+}
+
+BOOST_AUTO_TEST_CASE(test_bulk_build) {
+    std::vector<int> keys;
+    std::vector<std::string> values;
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back(i * 3);
+        values.push_back(std::to_string(i));
+    }
+    keys.push_back(0); // повтор: остаётся последнее значение
+    values.push_back("last");
+
+    HashTable ht;
+    ht.insert(-1, "old");
+    ht.bulkBuild(keys.data(), values.data(), keys.size());
+    BOOST_CHECK_EQUAL(ht.getSize(), 5000u);
+    BOOST_CHECK(!ht.contains(-1));
+    BOOST_CHECK(ht.search(0) == "last");
+    for (int i = 1; i < 5000; ++i) BOOST_REQUIRE(ht.search(i * 3) == std::to_string(i));
+
+    std::vector<std::pair<int, std::string>> pairs = {{1, "a"}, {2, "b"}, {3, "c"}};
+    GroupHashTable grouped;
+    grouped.bulkBuild(pairs.begin(), pairs.end());
+    BOOST_CHECK_EQUAL(grouped.getSize(), 3u);
+    BOOST_CHECK(grouped.search(2) == "b");
+}
+
+BOOST_AUTO_TEST_CASE(test_read_from_file_presizes) {
+    const std::string file = "presize_test.txt";
+    HashTable ht;
+    for (int i = 0; i < 3000; ++i) ht.insert(i, "value " + std::to_string(i));
+    ht.writeToFile(file);
+
+    HashTable loaded;
+    loaded.readFromFile(file);
+    HashTable expected;
+    expected.reserve(3000);
+    BOOST_CHECK_EQUAL(loaded.getCapacity(), expected.getCapacity());
+    BOOST_CHECK_EQUAL(loaded.getSize(), 3000u);
+    BOOST_CHECK(loaded.search(2999) == "value 2999");
+    std::remove(file.c_str());
+}
+
+using RobinHoodTable = BasicHashTable<int, std::string, std::hash<int>, std::equal_to<int>, RobinHoodProbing>;
+
+BOOST_AUTO_TEST_CASE(test_robin_hood_random_ops) {
+    RobinHoodTable ht;
+    HashTable ref;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> op_dis(0, 2);
+    std::uniform_int_distribution<> key_dis(-5000, 5000);
+
+    for (int i = 0; i < 50000; ++i) {
+        int key = key_dis(gen);
+        int op = op_dis(gen);
+        if (op == 0) {
+            BOOST_REQUIRE(ht.insert(key, std::to_string(i)) == ref.insert(key, std::to_string(i)));
+        } else if (op == 1) {
+            BOOST_REQUIRE(ht.search(key) == ref.search(key));
+        } else {
+            BOOST_REQUIRE(ht.remove(key) == ref.remove(key));
+        }
+        BOOST_REQUIRE(ht.getSize() == ref.getSize());
+    }
+    // Удаление сдвигает хвост назад — надгробий нет
+    BOOST_CHECK_EQUAL(ht.getTombstoneCount(), 0u);
+    for (int k = -5000; k <= 5000; ++k) BOOST_REQUIRE(ht.search(k) == ref.search(k));
+
+    // Расстояние в ctrl совпадает с позицией относительно домашнего слота
+    const uint8_t* ctrl = ht.getControl();
+    for (size_t i = 0; i < ht.getSlotCount(); ++i) {
+        if (!RobinHoodTable::isFullSlot(ctrl[i])) continue;
+        size_t home = PrimeModPolicy::index(std::hash<int>()(ht.getKeys()[i]), ht.getSlotCount());
+        size_t dist = (i + ht.getSlotCount() - home) % ht.getSlotCount();
+        BOOST_REQUIRE_EQUAL(ctrl[i], std::min<size_t>(dist, RobinHoodTable::kMaxDistance));
+    }
+}
+
+// Все ключи в четырёх домашних слотах: расстояния больше байта ctrl
+struct CollidingHash {
+    size_t operator()(int key) const { return static_cast<size_t>(key) & 3; }
+};
+
+BOOST_AUTO_TEST_CASE(test_robin_hood_long_clusters) {
+    BasicHashTable<int, int, CollidingHash, std::equal_to<int>, RobinHoodProbing, Pow2MixPolicy> ht;
+    for (int i = 0; i < 600; ++i) ht.insert(i, i * 2);
+    BOOST_CHECK(ht.probeStats().max > RobinHoodTable::kMaxDistance);
+
+    for (int i = 0; i < 600; i += 3) BOOST_REQUIRE(ht.remove(i));
+    for (int i = 0; i < 600; ++i) {
+        const int* v = ht.find(i);
+        BOOST_REQUIRE((v != nullptr) == (i % 3 != 0));
+        if (v) BOOST_REQUIRE_EQUAL(*v, i * 2);
+    }
+    BOOST_CHECK(!ht.contains(600));
+}
+
+BOOST_AUTO_TEST_CASE(test_robin_hood_rehash_and_snapshot) {
+    RobinHoodTable ht;
+    ht.setIncrementalRehash(4);
+    for (int i = 0; i < 3000; ++i) ht.insert(i * 11, std::to_string(i));
+    for (int i = 0; i < 3000; i += 4) ht.remove(i * 11);
+    for (int i = 0; i < 3000; ++i) BOOST_REQUIRE(ht.contains(i * 11) == (i % 4 != 0));
+
+    const std::string file = "robin_hood_snapshot.bin";
+    BOOST_REQUIRE(ht.writeSnapshot(file));
+    BasicHashTableView<int, std::string, std::hash<int>, std::equal_to<int>, RobinHoodProbing> view(file);
+    BOOST_REQUIRE(view.isOpen());
+    for (int i = 0; i < 3000; ++i) BOOST_REQUIRE(view.search(i * 11) == ht.search(i * 11));
+    HashTableView doubleHashed;
+    BOOST_CHECK(!doubleHashed.open(file));
+    std::remove(file.c_str());
+}
+
+// Файл, где size равен capacity: загрузка расширяет таблицу до kMaxLoad,
+// иначе Robin Hood заполнил бы все слоты и следующая вставка не нашла места
+BOOST_AUTO_TEST_CASE(test_deserialize_full_capacity) {
+    const std::string file = "robin_full.bin";
+    RobinHoodTable ht(101);
+    for (int i = 0; i < 61; ++i) ht.insert(i, std::to_string(i));
+    BOOST_REQUIRE(ht.serializeToBinary(file));
+    {
+        std::fstream f(file, std::ios::binary | std::ios::in | std::ios::out);
+        int capacity = 61; // простое: roundCapacity его не увеличит
+        f.seekp(sizeof(int));
+        f.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+    }
+
+    RobinHoodTable loaded;
+    BOOST_REQUIRE(loaded.deserializeFromBinary(file));
+    BOOST_CHECK_EQUAL(loaded.getSize(), 61u);
+    BOOST_CHECK(loaded.getLoadFactor() <= RobinHoodTable::kMaxLoad);
+    for (int i = 0; i < 61; ++i) BOOST_REQUIRE(loaded.search(i) == std::to_string(i));
+    BOOST_CHECK(loaded.insert(1000, "new"));
+    BOOST_CHECK(loaded.search(1000) == "new");
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_memory_usage) {
+    HashTable ht;
+    size_t empty = ht.memoryUsage();
+    ht.insert(1, "short");
+    BOOST_CHECK_EQUAL(ht.memoryUsage(), empty); // короткая строка внутри объекта
+    ht.insert(2, std::string(100, 'x'));
+    BOOST_CHECK(ht.memoryUsage() >= empty + 101);
+}
+
+BOOST_AUTO_TEST_CASE(test_compact_table) {
+    CompactHashTable ht;
+    HashTable ref;
+    std::mt19937 gen(9);
+    std::uniform_int_distribution<> op_dis(0, 3);
+    std::uniform_int_distribution<> key_dis(0, 3000);
+    std::uniform_int_distribution<> len_dis(0, 60);
+
+    for (int i = 0; i < 60000; ++i) {
+        int key = key_dis(gen);
+        int op = op_dis(gen);
+        if (op <= 1) {
+            std::string value(len_dis(gen), static_cast<char>('a' + i % 26));
+            BOOST_REQUIRE(ht.insert(key, value) == ref.insert(key, value));
+        } else if (op == 2) {
+            BOOST_REQUIRE(ht.search(key) == ref.search(key));
+        } else {
+            BOOST_REQUIRE(ht.remove(key) == ref.remove(key));
+        }
+        BOOST_REQUIRE_EQUAL(ht.getSize(), ref.getSize());
+    }
+    // Мёртвые записи убраны автоматически, арена не растёт без границ
+    BOOST_CHECK(ht.getDeadBytes() * 2 <= ht.getArenaBytes() + CompactHashTable::kMinCompactBytes);
+
+    ht.compact();
+    BOOST_CHECK_EQUAL(ht.getDeadBytes(), 0u);
+    for (int k = 0; k <= 3000; ++k) {
+        std::string_view v;
+        BOOST_REQUIRE(ht.find(k, v) == ref.contains(k));
+        if (ref.contains(k)) BOOST_REQUIRE(v == *ref.find(k));
+    }
+    BOOST_CHECK(ht.memoryUsage() < ref.memoryUsage());
+
+    ht.clear();
+    BOOST_CHECK(ht.isEmpty());
+    BOOST_CHECK_EQUAL(ht.getArenaBytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_stats_snapshot) {
+    HashTable ht;
+    for (int i = 0; i < 1000; ++i) ht.insert(i, "v");
+    for (int i = 0; i < 100; ++i) ht.remove(i);
+
+    HashTableStats stats = ht.getStats();
+    BOOST_CHECK_EQUAL(stats.live, 900u);
+    BOOST_CHECK_EQUAL(stats.tombstones, ht.getTombstoneCount());
+    BOOST_CHECK_EQUAL(stats.capacity, ht.getSlotCount());
+    if (!HashTable::kStatsEnabled) BOOST_CHECK_EQUAL(stats.searches, 0u);
+}
+
+#ifdef HASHTABLE_STATS
+BOOST_AUTO_TEST_CASE(test_stats_counters) {
+    HashTable ht;
+    for (int i = 0; i < 1000; ++i) ht.insert(i, "v");
+    ht.insert(5, "again");
+    for (int i = 0; i < 1000; ++i) ht.contains(i);
+    for (int i = 1000; i < 1500; ++i) ht.contains(i);
+    ht.remove(1);
+    ht.remove(-1);
+
+    HashTableStats stats = ht.getStats();
+    BOOST_CHECK_EQUAL(stats.inserts, 1000u);
+    BOOST_CHECK_EQUAL(stats.updates, 1u);
+    BOOST_CHECK_EQUAL(stats.searches, 1500u);
+    BOOST_CHECK_EQUAL(stats.hits, 1000u);
+    BOOST_CHECK_EQUAL(stats.removes, 1u);
+    BOOST_CHECK_EQUAL(stats.failedRemoves, 1u);
+    BOOST_CHECK(!stats.rehashMicros.empty());
+
+    size_t hits = 0, misses = 0;
+    for (size_t i = 0; i < HashTableStats::kHistogramSize; ++i) {
+        hits += stats.hitProbes[i];
+        misses += stats.missProbes[i];
+    }
+    BOOST_CHECK_EQUAL(hits, 1000u);
+    BOOST_CHECK_EQUAL(misses, 500u);
+    BOOST_CHECK(stats.maxProbe >= 1);
+
+    ht.resetStats();
+    BOOST_CHECK_EQUAL(ht.getStats().searches, 0u);
+
+    // Сброс посреди постепенного рехэша: перенос продолжает считать время
+    HashTable incremental;
+    incremental.setIncrementalRehash(4);
+    int key = 0;
+    while (!incremental.isRehashing()) incremental.insert(key++, "v");
+    incremental.resetStats();
+    BOOST_CHECK_EQUAL(incremental.getStats().rehashMicros.size(), 1u);
+    while (incremental.isRehashing()) incremental.insert(key++, "v");
+    BOOST_CHECK_EQUAL(incremental.getStats().rehashMicros.size(), 1u);
+    BOOST_CHECK(incremental.getStats().inserts > 0u);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(test_read_from_file_edge_cases) {
+    const std::string file = "loader_edge.txt";
+    {
+        std::ofstream out(file, std::ios::binary);
+        out << "1 one\n\n   -2 minus two\n3  leading space\n4\n1 one again\n+6 x\n5 tail";
+    }
+    HashTable ht;
+    ht.readFromFile(file);
+    BOOST_CHECK_EQUAL(ht.getSize(), 6u);
+    BOOST_CHECK(ht.search(6) == "x"); // ведущий '+', как у operator>>
+    BOOST_CHECK(ht.search(1) == "one again");
+    BOOST_CHECK(ht.search(-2) == "minus two");
+    BOOST_CHECK(ht.search(3) == " leading space");
+    BOOST_CHECK(ht.contains(4) && ht.search(4).empty());
+    BOOST_CHECK(ht.search(5) == "tail");
+
+    // Как и потоковое чтение, разбор останавливается на первой плохой строке
+    {
+        std::ofstream out(file, std::ios::binary);
+        out << "1 a\nbad line\n2 b\n";
+    }
+    ht.readFromFile(file);
+    BOOST_CHECK_EQUAL(ht.getSize(), 1u);
+    BOOST_CHECK(!ht.contains(2));
+
+    { std::ofstream out(file, std::ios::binary); }
+    ht.readFromFile(file);
+    BOOST_CHECK(ht.isEmpty());
+    std::remove(file.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_text_chunks) {
+    const std::string file = "loader_parallel.txt";
+    const int LINES = 300000; // несколько кусков по kMinTextChunk
+    {
+        std::ofstream out(file, std::ios::binary);
+        for (int i = 0; i < LINES; ++i) out << i << " value " << i << "\n";
+    }
+    std::vector<hashtable_io::TextChunk<int, std::string>> chunks;
+    BOOST_REQUIRE(hashtable_io::parseMappedText(file, chunks, 4));
+    BOOST_CHECK(chunks.size() > 1);
+
+    int expected = 0;
+    for (const auto& chunk : chunks) {
+        BOOST_CHECK(!chunk.stopped);
+        for (const auto& kv : chunk.pairs) {
+            BOOST_REQUIRE_EQUAL(kv.first, expected);
+            BOOST_REQUIRE(kv.second == "value " + std::to_string(expected));
+            ++expected;
+        }
+    }
+    BOOST_CHECK_EQUAL(expected, LINES);
+
+    BasicHashTable<int, long long> numbers;
+    {
+        std::ofstream out(file, std::ios::binary);
+        out << "7 70000000000\n8   -5\n";
+    }
+    numbers.readFromFile(file);
+    BOOST_CHECK_EQUAL(numbers.search(7), 70000000000LL);
+    BOOST_CHECK_EQUAL(numbers.search(8), -5);
+    std::remove(file.c_str());
+}
 #endif